@@ -0,0 +1,17 @@
+# Generates a C++ header embedding the bytecode of a compiled Java class, so
+# that this class can be defined with DefineClass when the JVM is created.
+#
+# Expected variables:
+#   INPUT   The path of the .class file to embed.
+#   OUTPUT  The path of the header to generate.
+#   NAME    The name of the array holding the bytecode.
+
+file(READ "${INPUT}" content HEX)
+string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," bytes "${content}")
+
+file(
+    WRITE "${OUTPUT}"
+    "// Generated by cmake/embed-class.cmake from ${INPUT}: do not edit.\n"
+    "#pragma once\n\n"
+    "static const unsigned char ${NAME}[] = {${bytes}};\n"
+)
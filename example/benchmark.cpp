@@ -0,0 +1,440 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#include <getopt.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <jni.h>
+
+#include <crillab-easyjni/JavaArray.h>
+#include <crillab-easyjni/JavaArrayAlgorithms.h>
+#include <crillab-easyjni/JavaArrayKernels.h>
+#include <crillab-easyjni/JavaBulkDispatcher.h>
+#include <crillab-easyjni/JavaClass.h>
+#include <crillab-easyjni/JavaExecutor.h>
+#include <crillab-easyjni/JavaMethod.h>
+#include <crillab-easyjni/JavaVirtualMachine.h>
+#include <crillab-easyjni/JavaVirtualMachineBuilder.h>
+#include <crillab-easyjni/JavaVirtualMachineRegistry.h>
+
+using namespace easyjni;
+using namespace std;
+
+/**
+ * The number of elements in the arrays used by the benchmarks.
+ */
+static int arraySize = 1 << 22;
+
+/**
+ * The number of calls made by each run of the benchmarks measuring single calls.
+ */
+static constexpr int NB_CALLS = 100000;
+
+/**
+ * The number of times each measured operation is executed.
+ */
+static int nbRuns = 20;
+
+/**
+ * The value in which the results of the measured operations are accumulated,
+ * so that the compiler does not optimize these operations away.
+ */
+static volatile uint64_t sink;
+
+/**
+ * Accumulates a result of a measured operation into the sink.
+ *
+ * @tparam T The type of the result.
+ *
+ * @param value The result to accumulate.
+ */
+template<typename T>
+static void consume(const T &value) {
+    uint64_t bits = 0;
+    memcpy(&bits, &value, min(sizeof(T), sizeof(bits)));
+    sink = sink ^ bits;
+}
+
+/**
+ * Measures the average time taken by an operation, and prints it.
+ * The operation is executed once before being measured, to let the JVM compile
+ * the Java code it runs.
+ *
+ * @tparam Operation The type of the operation.
+ *
+ * @param name The name of the operation.
+ * @param operation The operation to measure.
+ *
+ * @return The average time taken by the operation, in microseconds.
+ */
+template<typename Operation>
+static double measure(const string &name, Operation operation) {
+    operation();
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < nbRuns; i++) {
+        operation();
+    }
+    chrono::duration<double, micro> elapsed = chrono::steady_clock::now() - start;
+    double average = elapsed.count() / nbRuns;
+    cout << "    " << left << setw(48) << name << right << setw(14) << fixed << setprecision(2)
+         << average << " us" << endl;
+    return average;
+}
+
+/**
+ * Compares the kernels operating on Java arrays with element-wise accesses and
+ * with plain Java loops running in the same JVM.
+ */
+static void benchmarkKernels() {
+    auto jvm = JavaVirtualMachineRegistry::get();
+    vector<jint> values(static_cast<size_t>(arraySize));
+    vector<jbyte> bytes(static_cast<size_t>(arraySize));
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = static_cast<jint>(i * 2654435761U);
+        bytes[i] = static_cast<jbyte>(values[i]);
+    }
+    auto ints = jvm->createIntArray(values);
+    auto byteArray = jvm->createByteArray(bytes);
+
+    auto baselines = jvm->loadClass("fr/univartois/cril/easyjni/example/Baselines");
+    auto javaSum = baselines.getStaticMethod<jlong(JavaArray<jint>)>("sum");
+    auto javaDot = baselines.getStaticMethod<jlong(JavaArray<jint>, JavaArray<jint>)>("dot");
+    auto javaCrc32 = baselines.getStaticMethod<jint(JavaArray<jbyte>)>("crc32");
+
+    cout << "kernels (" << JavaArrayKernels::getInstructionSet() << ", " << arraySize << " elements)" << endl;
+    measure("sum: element-wise get()", [&]() {
+        jlong sum = 0;
+        for (int i = 0; i < arraySize; i++) {
+            sum += ints.get(i);
+        }
+        consume(sum);
+    });
+    measure("sum: Java loop", [&]() { consume(javaSum.invokeStatic(baselines, ints)); });
+    measure("sum: kernel", [&]() { consume(JavaArrayKernels::sum(ints)); });
+    measure("dot: Java loop", [&]() { consume(javaDot.invokeStatic(baselines, ints, ints)); });
+    measure("dot: kernel", [&]() { consume(JavaArrayKernels::dot(ints, ints)); });
+    measure("crc32: java.util.zip.CRC32", [&]() { consume(javaCrc32.invokeStatic(baselines, byteArray)); });
+    measure("crc32: kernel", [&]() { consume(JavaArrayKernels::crc32(byteArray)); });
+    measure("xxHash64: kernel", [&]() { consume(JavaArrayKernels::xxHash64(byteArray)); });
+}
+
+/**
+ * Compares the native sort of Java arrays with java.util.Arrays, and with a copy
+ * of the array sorted in C++ before being copied back.
+ * Each measure includes the copy restoring the unsorted values, which is also
+ * measured alone.
+ */
+static void benchmarkAlgorithms() {
+    auto jvm = JavaVirtualMachineRegistry::get();
+    vector<jlong> values(static_cast<size_t>(arraySize));
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = static_cast<jlong>(i * 0x9E3779B97F4A7C15ULL);
+    }
+    auto longs = jvm->createLongArray(values);
+    span<const jlong> unsorted(values);
+
+    auto arrays = jvm->loadClass("java/util/Arrays");
+    auto javaSort = arrays.getStaticMethod<void(JavaArray<jlong>)>("sort");
+    auto javaParallelSort = arrays.getStaticMethod<void(JavaArray<jlong>)>("parallelSort");
+
+    cout << "algorithms (" << arraySize << " elements)" << endl;
+    measure("reset only", [&]() { longs.setRegion(0, unsorted); });
+    measure("sort: Arrays.sort()", [&]() {
+        longs.setRegion(0, unsorted);
+        javaSort.invokeStatic(arrays, longs);
+    });
+    measure("sort: Arrays.parallelSort()", [&]() {
+        longs.setRegion(0, unsorted);
+        javaParallelSort.invokeStatic(arrays, longs);
+    });
+    measure("sort: copy, std::sort() and copy back", [&]() {
+        longs.setRegion(0, unsorted);
+        auto copy = longs.toVector();
+        std::sort(copy.begin(), copy.end());
+        longs.setRegion(0, span<const jlong>(copy));
+    });
+    measure("sort: in place, 1 thread", [&]() {
+        longs.setRegion(0, unsorted);
+        JavaArrayAlgorithms::sort(longs, 1);
+    });
+    measure("sort: in place, all threads", [&]() {
+        longs.setRegion(0, unsorted);
+        JavaArrayAlgorithms::sort(longs);
+    });
+    measure("binarySearch: in place", [&]() { consume(JavaArrayAlgorithms::binarySearch(longs, values[0])); });
+}
+
+/**
+ * Compares the cached class lookups of loadClass() with looking up the classes
+ * and creating a global reference each time, as loadClass() used to do.
+ */
+static void benchmarkClasses() {
+    auto jvm = JavaVirtualMachineRegistry::get();
+    auto env = JavaVirtualMachineRegistry::getEnvironment();
+    vector<string> names = {"java/lang/String", "java/lang/Integer", "java/util/ArrayList", "java/util/HashMap"};
+
+    cout << "classes (" << NB_CALLS << " loads per run)" << endl;
+    measure("FindClass() and NewGlobalRef()", [&]() {
+        for (int i = 0; i < NB_CALLS; i++) {
+            jclass localClass = env->FindClass(names[static_cast<size_t>(i) % names.size()].c_str());
+            auto globalClass = env->NewGlobalRef(localClass);
+            env->DeleteLocalRef(localClass);
+            consume(globalClass);
+            env->DeleteGlobalRef(globalClass);
+        }
+    });
+    measure("loadClass(), cache invalidated before each run", [&]() {
+        jvm->invalidateClassCache();
+        for (int i = 0; i < NB_CALLS; i++) {
+            consume(*jvm->loadClass(names[static_cast<size_t>(i) % names.size()]));
+        }
+    });
+    measure("loadClass(), cached", [&]() {
+        for (int i = 0; i < NB_CALLS; i++) {
+            consume(*jvm->loadClass(names[static_cast<size_t>(i) % names.size()]));
+        }
+    });
+    jvm->reclaimInvalidatedClasses();
+    cout << "    classes in the cache: " << JavaVirtualMachine::getClassCacheSize() << endl;
+}
+
+/**
+ * Compares the boxing and unboxing of integers by wrap() and unwrapAsInt() with
+ * looking up the boxing class and method on each call, as these methods used to
+ * do.
+ * Small values are those for which wrap() caches the boxed objects.
+ */
+static void benchmarkBoxing() {
+    auto jvm = JavaVirtualMachineRegistry::get();
+    auto env = JavaVirtualMachineRegistry::getEnvironment();
+
+    cout << "boxing (" << NB_CALLS << " values per run)" << endl;
+    measure("wrap: looked up on each call", [&]() {
+        for (int i = 0; i < NB_CALLS; i++) {
+            jclass integerClass = env->FindClass("java/lang/Integer");
+            jmethodID valueOf = env->GetStaticMethodID(integerClass, "valueOf", "(I)Ljava/lang/Integer;");
+            jobject boxed = env->CallStaticObjectMethod(integerClass, valueOf, i);
+            consume(boxed);
+            env->DeleteLocalRef(boxed);
+            env->DeleteLocalRef(integerClass);
+        }
+    });
+    measure("wrap: small values", [&]() {
+        for (int i = 0; i < NB_CALLS; i++) {
+            auto boxed = jvm->wrap(static_cast<jint>(i & 0x7F));
+            consume(*boxed);
+            env->DeleteLocalRef(*boxed);
+        }
+    });
+    measure("wrap: large values", [&]() {
+        for (int i = 0; i < NB_CALLS; i++) {
+            auto boxed = jvm->wrap(static_cast<jint>(i + 128));
+            consume(*boxed);
+            env->DeleteLocalRef(*boxed);
+        }
+    });
+
+    auto boxed = jvm->wrap(static_cast<jint>(1 << 20));
+    measure("unwrap: looked up on each call", [&]() {
+        for (int i = 0; i < NB_CALLS; i++) {
+            jclass integerClass = env->FindClass("java/lang/Integer");
+            jmethodID intValue = env->GetMethodID(integerClass, "intValue", "()I");
+            consume(env->CallIntMethod(*boxed, intValue));
+            env->DeleteLocalRef(integerClass);
+        }
+    });
+    measure("unwrap: unwrapAsInt()", [&]() {
+        for (int i = 0; i < NB_CALLS; i++) {
+            consume(jvm->unwrapAsInt(boxed));
+        }
+    });
+}
+
+/**
+ * Compares the calls executed in batches by a JavaBulkDispatcher with the same
+ * calls invoked one by one, for different numbers of calls per batch.
+ * The calls set the bits of a java.util.BitSet, so that they neither return a
+ * result nor take an object as parameter, which are not amortized over a batch.
+ */
+static void benchmarkDispatch() {
+    auto jvm = JavaVirtualMachineRegistry::get();
+    auto bitSetClass = jvm->loadClass("java/util/BitSet");
+    auto bits = bitSetClass.newInstance();
+    auto set = bitSetClass.getMethod<void(jint)>("set");
+
+    cout << "dispatch (" << NB_CALLS << " calls per run)" << endl;
+    measure("invoke()", [&]() {
+        for (int i = 0; i < NB_CALLS; i++) {
+            set.invoke(bits, i);
+        }
+    });
+
+    JavaBulkDispatcher dispatcher;
+    auto receiver = dispatcher.bind(bits);
+    for (int batchSize : {16, 256, 4096, NB_CALLS}) {
+        measure("JavaBulkDispatcher, " + to_string(batchSize) + " calls per batch", [&]() {
+            for (int i = 0; i < NB_CALLS; i++) {
+                dispatcher.invoke(bitSetClass, set, receiver, i);
+                if (static_cast<int>(dispatcher.size()) == batchSize) {
+                    dispatcher.flush();
+                }
+            }
+            dispatcher.flush();
+        });
+    }
+}
+
+/**
+ * Prints the throughput of a copy.
+ *
+ * @param nbBytes The number of bytes copied.
+ * @param micros The time taken by the copy, in microseconds.
+ */
+static void printThroughput(size_t nbBytes, double micros) {
+    cout << "    " << left << setw(48) << "  throughput" << right << setw(14) << fixed << setprecision(2)
+         << (static_cast<double>(nbBytes) / (micros * 1000)) << " GB/s" << endl;
+}
+
+/**
+ * Measures the throughput of the parallel copies of a large array for increasing
+ * numbers of threads, compared with a single region copy.
+ * The copied array holds 2 longs per element of the arrays of the other benchmarks.
+ */
+static void benchmarkCopy() {
+    auto jvm = JavaVirtualMachineRegistry::get();
+    auto longs = jvm->createLongArray(2 * arraySize);
+    vector<jlong> values(2 * static_cast<size_t>(arraySize));
+    span<jlong> elements(values);
+    auto nbBytes = elements.size_bytes();
+
+    cout << "copy (" << (nbBytes >> 20) << " MB)" << endl;
+    printThroughput(nbBytes, measure("getRegion()", [&]() { longs.getRegion(0, elements); }));
+    printThroughput(nbBytes, measure("setRegion()", [&]() { longs.setRegion(0, span<const jlong>(elements)); }));
+
+    unsigned maxThreads = max(1U, thread::hardware_concurrency());
+    for (unsigned nbThreads = 1; nbThreads <= maxThreads; nbThreads *= 2) {
+        JavaExecutor executor(nbThreads);
+        auto suffix = ", " + to_string(nbThreads) + " thread(s)";
+        printThroughput(nbBytes, measure("parallelCopyTo()" + suffix, [&]() {
+            longs.parallelCopyTo(executor, 0, elements);
+        }));
+        printThroughput(nbBytes, measure("parallelCopyFrom()" + suffix, [&]() {
+            longs.parallelCopyFrom(executor, 0, span<const jlong>(elements));
+        }));
+    }
+}
+
+/**
+ * The benchmarks that can be run, associated with their names.
+ */
+static const vector<pair<string, function<void()>>> BENCHMARKS = {
+        {"kernels", benchmarkKernels},
+        {"algorithms", benchmarkAlgorithms},
+        {"classes", benchmarkClasses},
+        {"boxing", benchmarkBoxing},
+        {"dispatch", benchmarkDispatch},
+        {"copy", benchmarkCopy},
+};
+
+/**
+ * Builds the Java Virtual Machine used by the benchmarks from the given command
+ * line arguments.
+ *
+ * @param argc The number of arguments given to the program.
+ * @param argv The command line arguments.
+ *
+ * @return The index of the first name of benchmark to run in argv.
+ */
+int buildJvmFromArguments(int argc, char *argv[]) {
+    JavaVirtualMachineBuilder builder;
+    builder.setVersion(JNI_VERSION_10);
+    opterr = 0;
+
+    // Parsing named arguments.
+    bool classpath = false;
+    for (int opt; (opt = getopt(argc, argv, ":c:n:r:")) != -1;) {
+        if (opt == ':') {
+            string message = "Missing argument for option `-";
+            message += static_cast<char>(optopt);
+            message += '\'';
+            throw invalid_argument(message);
+
+        } else if (opt == 'c') {
+            builder.addToClasspath(optarg);
+            classpath = true;
+
+        } else if (opt == 'n') {
+            arraySize = stoi(optarg);
+
+        } else if (opt == 'r') {
+            nbRuns = stoi(optarg);
+
+        } else {
+            string message = "Unknown option `-";
+            message += static_cast<char>(optopt);
+            message += '\'';
+            throw invalid_argument(message);
+        }
+    }
+
+    // Building the Java Virtual Machine.
+    if (!classpath) {
+        builder.addToClasspath(EASYJNI_BENCHMARK_CLASSPATH);
+    }
+    auto jvm = builder.buildJavaVirtualMachine();
+    JavaVirtualMachineRegistry::set(jvm);
+    return optind;
+}
+
+/**
+ * Runs the benchmarks of EasyJNI.
+ * The names of the benchmarks to run may be given as arguments (all the benchmarks
+ * are run if none is given), with the options -n to set the size of the arrays,
+ * -r to set the number of runs of each operation, and -c to set the classpath
+ * where to find the Java baselines.
+ *
+ * @param argc The number of arguments given to the program.
+ * @param argv The command line arguments.
+ *
+ * @return The value 0 upon success.
+ */
+int main(int argc, char *argv[]) {
+    int first = buildJvmFromArguments(argc, argv);
+    vector<string> names(argv + first, argv + argc);
+    for (const auto &[name, benchmark] : BENCHMARKS) {
+        if (names.empty() || (find(names.begin(), names.end(), name) != names.end())) {
+            benchmark();
+        }
+    }
+    return 0;
+}
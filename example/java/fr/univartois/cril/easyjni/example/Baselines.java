@@ -0,0 +1,88 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+package fr.univartois.cril.easyjni.example;
+
+import java.util.zip.CRC32;
+
+/**
+ * The Baselines gives plain Java implementations of the operations measured by
+ * the benchmarks of EasyJNI, so that the native implementations can be compared
+ * with what the Java Virtual Machine achieves on its own.
+ *
+ * @author Romain Wallon
+ *
+ * @version 0.1.0
+ */
+public final class Baselines {
+
+    /**
+     * Disables instantiation.
+     */
+    private Baselines() {
+        throw new AssertionError("No Baselines instances for you!");
+    }
+
+    /**
+     * Computes the sum of the given values with a plain loop.
+     *
+     * @param values The values to sum.
+     *
+     * @return The sum of the values.
+     */
+    public static long sum(int[] values) {
+        long sum = 0;
+        for (int value : values) {
+            sum += value;
+        }
+        return sum;
+    }
+
+    /**
+     * Computes the dot product of two vectors with a plain loop.
+     *
+     * @param x The first vector.
+     * @param y The second vector.
+     *
+     * @return The dot product of the vectors.
+     */
+    public static long dot(int[] x, int[] y) {
+        long dot = 0;
+        for (int i = 0; i < x.length; i++) {
+            dot += (long) x[i] * y[i];
+        }
+        return dot;
+    }
+
+    /**
+     * Computes the CRC-32 checksum of the given bytes with the (intrinsified)
+     * implementation of the JDK.
+     *
+     * @param bytes The bytes to checksum.
+     *
+     * @return The checksum of the bytes.
+     */
+    public static int crc32(byte[] bytes) {
+        CRC32 crc = new CRC32();
+        crc.update(bytes, 0, bytes.length);
+        return (int) crc.getValue();
+    }
+
+}
@@ -87,12 +87,8 @@ int buildJvmFromArguments(int argc, char *argv[], string &mainClass) {
  * @return The array of arguments to pass to the Java program.
  */
 JavaArray<JavaObject> buildJavaArguments(int first, int argc, char *argv[]) {
-    auto jvm = JavaVirtualMachineRegistry::get();
-    auto args = jvm->createObjectArray(argc - optind, jvm->loadClass("java/lang/String"));
-    for (int i = first; i < argc; i++) {
-        args.set(i - first, jvm->toJavaString(argv[i]));
-    }
-    return args;
+    vector<string> args(argv + first, argv + argc);
+    return JavaVirtualMachineRegistry::get()->createStringArray(args);
 }
 
 /**
@@ -103,7 +99,7 @@ JavaArray<JavaObject> buildJavaArguments(int first, int argc, char *argv[]) {
  */
 void javaMain(const string &mainClass, JavaArray<JavaObject> args) {
     auto cls = JavaVirtualMachineRegistry::get()->loadClass(mainClass);
-    auto mtd = cls.getStaticMethod("main", METHOD(VOID, ARRAY(CLASS(java/lang/String))));
+    auto mtd = cls.getStaticMethod<void(JavaArray<JString>)>("main");
     mtd.invokeStatic(cls, *args);
 }
 
@@ -0,0 +1,241 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#ifndef EASYJNI_JAVAARGUMENTS_H
+#define EASYJNI_JAVAARGUMENTS_H
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <jni.h>
+
+#include "JavaClass.h"
+#include "JavaContext.h"
+#include "JavaObject.h"
+#include "JniException.h"
+
+namespace easyjni {
+
+    /**
+     * Checks whether a type is an instantiation of JavaArray.
+     *
+     * @tparam T The type to check.
+     */
+    template<typename T>
+    struct IsJavaArray : std::false_type {};
+
+    /**
+     * Checks whether a type is an instantiation of JavaArray.
+     *
+     * @tparam T The type of the elements in the array.
+     */
+    template<typename T>
+    struct IsJavaArray<easyjni::JavaArray<T>> : std::true_type {};
+
+    /**
+     * The JavaArguments packs the arguments of a Java method into an array of
+     * jvalue allocated on the stack, so that this method can be invoked with the
+     * Call<Type>MethodA functions of JNI.
+     * The local references created to convert C++ strings into Java strings are
+     * deleted when the arguments are destroyed.
+     *
+     * @tparam N The number of arguments.
+     *
+     * @author Romain Wallon
+     *
+     * @version 0.1.0
+     */
+    template<std::size_t N>
+    class JavaArguments {
+
+    private:
+
+        /**
+         * The native Java Environment provided by JNI.
+         */
+        JNIEnv *env;
+
+        /**
+         * The packed arguments.
+         */
+        jvalue values[(N == 0) ? 1 : N];
+
+        /**
+         * The local references created while converting the arguments.
+         */
+        jobject locals[(N == 0) ? 1 : N];
+
+        /**
+         * The number of local references created while converting the arguments.
+         */
+        std::size_t nbLocals;
+
+    public:
+
+        /**
+         * Creates new JavaArguments.
+         *
+         * @tparam Args The types of the arguments.
+         *
+         * @param env The native Java Environment provided by JNI.
+         * @param args The arguments to pack.
+         *
+         * @throws JniException If a Java string cannot be created for an argument.
+         */
+        template<typename... Args>
+        explicit JavaArguments(JNIEnv *env, Args &&... args) :
+                env(env),
+                values(),
+                locals(),
+                nbLocals(0) {
+            static_assert(sizeof...(Args) == N, "Wrong number of arguments");
+            std::size_t index = 0;
+            ((values[index++] = convert(std::forward<Args>(args))), ...);
+        }
+
+        /**
+         * Forbids the copy of packed arguments.
+         */
+        JavaArguments(const JavaArguments &) = delete;
+
+        /**
+         * Forbids the copy of packed arguments.
+         */
+        JavaArguments &operator=(const JavaArguments &) = delete;
+
+        /**
+         * Destroys these arguments, and deletes the local references they created.
+         */
+        ~JavaArguments() {
+            deleteLocals();
+        }
+
+        /**
+         * Gives the packed arguments.
+         *
+         * @return The array of the packed arguments.
+         */
+        [[nodiscard]] const jvalue *data() const {
+            return values;
+        }
+
+    private:
+
+        /**
+         * Converts an argument into a jvalue.
+         * Primitive values are stored in the field matching their exact type, so that
+         * they are not promoted as with C variadic arguments.
+         *
+         * @tparam A The type of the argument.
+         *
+         * @param arg The argument to convert.
+         *
+         * @return The converted argument.
+         */
+        template<typename A>
+        jvalue convert(A &&arg) {
+            using D = std::decay_t<A>;
+            jvalue value {};
+
+            if constexpr (std::is_same_v<D, bool> || std::is_same_v<D, jboolean>) {
+                value.z = arg ? JNI_TRUE : JNI_FALSE;
+
+            } else if constexpr (std::is_same_v<D, jbyte>) {
+                value.b = arg;
+
+            } else if constexpr (std::is_same_v<D, jchar>) {
+                value.c = arg;
+
+            } else if constexpr (std::is_same_v<D, jshort>) {
+                value.s = arg;
+
+            } else if constexpr (std::is_same_v<D, jint> || std::is_same_v<D, int>) {
+                value.i = static_cast<jint>(arg);
+
+            } else if constexpr (std::is_same_v<D, jlong> || std::is_same_v<D, long long>) {
+                value.j = static_cast<jlong>(arg);
+
+            } else if constexpr (std::is_same_v<D, jfloat>) {
+                value.f = arg;
+
+            } else if constexpr (std::is_same_v<D, jdouble>) {
+                value.d = arg;
+
+            } else if constexpr (std::is_same_v<D, easyjni::JavaObject> || std::is_same_v<D, easyjni::JavaClass>
+                                 || IsJavaArray<D>::value) {
+                D copy = arg;
+                value.l = *copy;
+
+            } else if constexpr (std::is_same_v<D, std::nullptr_t>) {
+                value.l = nullptr;
+
+            } else if constexpr (std::is_convertible_v<D, jobject>) {
+                value.l = arg;
+
+            } else if constexpr (std::is_same_v<D, std::string>) {
+                value.l = newString(arg.c_str());
+
+            } else if constexpr (std::is_same_v<D, const char *> || std::is_same_v<D, char *>) {
+                value.l = newString(arg);
+
+            } else {
+                static_assert(alwaysFalse<D>, "This type cannot be passed to a Java method");
+            }
+
+            return value;
+        }
+
+        /**
+         * Creates a Java string, which is deleted when the arguments are destroyed.
+         *
+         * @param str The C++ string to convert.
+         *
+         * @return The local reference to the created Java string.
+         *
+         * @throws JniException If the Java string cannot be created.
+         */
+        jobject newString(const char *str) {
+            jobject javaString = env->NewStringUTF(str);
+            if (javaString == nullptr) {
+                // The destructor is not run when the constructor throws.
+                deleteLocals();
+                JavaContext(env).checkException();
+                throw JniException("Could not create Java string");
+            }
+            return locals[nbLocals++] = javaString;
+        }
+
+        /**
+         * Deletes the local references created while converting the arguments.
+         */
+        void deleteLocals() {
+            for (std::size_t i = 0; i < nbLocals; i++) {
+                env->DeleteLocalRef(locals[i]);
+            }
+            nbLocals = 0;
+        }
+
+    };
+
+}
+
+#endif
@@ -21,9 +21,23 @@
 #ifndef EASYJNI_JAVAARRAY_H
 #define EASYJNI_JAVAARRAY_H
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <span>
+#include <type_traits>
+#include <vector>
+
 #include <jni.h>
 
+#include "JavaArrayIterator.h"
+#include "JavaArrayView.h"
+#include "JavaContext.h"
+#include "JavaExecutor.h"
 #include "JavaVirtualMachineRegistry.h"
+#include "JniException.h"
 
 namespace easyjni {
 
@@ -83,6 +97,12 @@ namespace easyjni {
 
     public:
 
+        /**
+         * The minimum size (in bytes) of the regions copied by each thread in a
+         * parallel copy.
+         */
+        static constexpr std::size_t PARALLEL_COPY_MIN_BYTES = 1 << 20;
+
         /**
          * Gives the element at the specified index in this array.
          *
@@ -90,7 +110,19 @@ namespace easyjni {
          *
          * @return The element at the specified index.
          */
-        T get(int index);
+        T get(int index) {
+            return get(JavaVirtualMachineRegistry::getContext(), index);
+        }
+
+        /**
+         * Gives the element at the specified index in this array, using the given context.
+         *
+         * @param context The context of the current thread.
+         * @param index The index of the element to get.
+         *
+         * @return The element at the specified index.
+         */
+        T get(const easyjni::JavaContext &context, int index);
 
         /**
          * Sets the element at the specified index in this array.
@@ -98,7 +130,18 @@ namespace easyjni {
          * @param index The index of the element to set.
          * @param elt The element to set at the specified index.
          */
-        void set(int index, T elt);
+        void set(int index, T elt) {
+            set(JavaVirtualMachineRegistry::getContext(), index, elt);
+        }
+
+        /**
+         * Sets the element at the specified index in this array, using the given context.
+         *
+         * @param context The context of the current thread.
+         * @param index The index of the element to set.
+         * @param elt The element to set at the specified index.
+         */
+        void set(const easyjni::JavaContext &context, int index, T elt);
 
         /**
          * Gives the length of this array.
@@ -106,11 +149,419 @@ namespace easyjni {
          * @return The length of this array.
          */
         int length() {
-            auto len = JavaVirtualMachineRegistry::getEnvironment()->GetArrayLength(array);
-            JavaVirtualMachineRegistry::get()->checkException();
+            return length(JavaVirtualMachineRegistry::getContext());
+        }
+
+        /**
+         * Gives the length of this array, using the given context.
+         *
+         * @param context The context of the current thread.
+         *
+         * @return The length of this array.
+         */
+        int length(const easyjni::JavaContext &context) {
+            auto len = context.getEnvironment()->GetArrayLength(array);
+            context.afterCall();
             return len;
         }
 
+        /**
+         * Copies the elements of this array starting at the given offset into the
+         * given span, which determines the number of elements to copy.
+         *
+         * @param offset The index of the first element to copy.
+         * @param elements The span in which to copy the elements.
+         *
+         * @throws JniException If the region is out of the bounds of this array.
+         */
+        void getRegion(int offset, std::span<T> elements) requires (!std::is_same_v<T, easyjni::JavaObject>) {
+            getRegion(JavaVirtualMachineRegistry::getContext(), offset, elements);
+        }
+
+        /**
+         * Copies the elements of this array starting at the given offset into the
+         * given span, which determines the number of elements to copy, using the
+         * given context.
+         * The elements are copied with a single JNI call.
+         *
+         * @param context The context of the current thread.
+         * @param offset The index of the first element to copy.
+         * @param elements The span in which to copy the elements.
+         *
+         * @throws JniException If the region is out of the bounds of this array, and
+         *         the context checks exceptions immediately.
+         */
+        void getRegion(const easyjni::JavaContext &context, int offset, std::span<T> elements)
+                requires (!std::is_same_v<T, easyjni::JavaObject>);
+
+        /**
+         * Copies the elements of the given span into this array, starting at the
+         * given offset.
+         *
+         * @param offset The index of the first element to set.
+         * @param elements The elements to copy into this array.
+         *
+         * @throws JniException If the region is out of the bounds of this array.
+         */
+        void setRegion(int offset, std::span<const T> elements) requires (!std::is_same_v<T, easyjni::JavaObject>) {
+            setRegion(JavaVirtualMachineRegistry::getContext(), offset, elements);
+        }
+
+        /**
+         * Copies the elements of the given span into this array, starting at the
+         * given offset, using the given context.
+         * The elements are copied with a single JNI call.
+         *
+         * @param context The context of the current thread.
+         * @param offset The index of the first element to set.
+         * @param elements The elements to copy into this array.
+         *
+         * @throws JniException If the region is out of the bounds of this array, and
+         *         the context checks exceptions immediately.
+         */
+        void setRegion(const easyjni::JavaContext &context, int offset, std::span<const T> elements)
+                requires (!std::is_same_v<T, easyjni::JavaObject>);
+
+        /**
+         * Copies all the elements of this array into a vector.
+         *
+         * @return The vector containing the elements of this array.
+         *
+         * @throws JniException If an error occurred while copying the elements.
+         */
+        std::vector<T> toVector() requires (!std::is_same_v<T, easyjni::JavaObject>) {
+            return toVector(JavaVirtualMachineRegistry::getContext());
+        }
+
+        /**
+         * Copies all the elements of this array into a vector, using the given context.
+         *
+         * @param context The context of the current thread.
+         *
+         * @return The vector containing the elements of this array.
+         *
+         * @throws JniException If an error occurred while copying the elements, and
+         *         the context checks exceptions immediately.
+         */
+        std::vector<T> toVector(const easyjni::JavaContext &context) requires (!std::is_same_v<T, easyjni::JavaObject>) {
+            std::vector<T> elements(context.getEnvironment()->GetArrayLength(array));
+            getRegion(context, 0, elements);
+            return elements;
+        }
+
+        /**
+         * Replaces all the elements of this array with those of the given span,
+         * which must have the same length as this array.
+         *
+         * @param elements The new elements of this array.
+         *
+         * @throws JniException If the span and this array do not have the same length,
+         *         or if an error occurred while copying the elements.
+         */
+        void assign(std::span<const T> elements) requires (!std::is_same_v<T, easyjni::JavaObject>) {
+            assign(JavaVirtualMachineRegistry::getContext(), elements);
+        }
+
+        /**
+         * Replaces all the elements of this array with those of the given span,
+         * which must have the same length as this array, using the given context.
+         *
+         * @param context The context of the current thread.
+         * @param elements The new elements of this array.
+         *
+         * @throws JniException If the span and this array do not have the same length,
+         *         or if an error occurred while copying the elements and the context
+         *         checks exceptions immediately.
+         */
+        void assign(const easyjni::JavaContext &context, std::span<const T> elements)
+                requires (!std::is_same_v<T, easyjni::JavaObject>) {
+            if (static_cast<std::size_t>(context.getEnvironment()->GetArrayLength(array)) != elements.size()) {
+                throw JniException("Cannot assign elements to an array of a different length");
+            }
+            setRegion(context, 0, elements);
+        }
+
+        /**
+         * Copies the elements of this array starting at the given offset into the
+         * given span, splitting the copy among the threads of the given executor.
+         *
+         * @param executor The executor performing the copy.
+         * @param offset The index of the first element to copy.
+         * @param elements The span in which to copy the elements.
+         *
+         * @throws JniException If the region is out of the bounds of this array.
+         */
+        void parallelCopyTo(easyjni::JavaExecutor &executor, int offset, std::span<T> elements)
+                requires (!std::is_same_v<T, easyjni::JavaObject>) {
+            parallelCopyTo(JavaVirtualMachineRegistry::getContext(), executor, offset, elements);
+        }
+
+        /**
+         * Copies the elements of this array starting at the given offset into the
+         * given span, splitting the copy among the threads of the given executor,
+         * using the given context.
+         * The copy is split into disjoint regions of at least PARALLEL_COPY_MIN_BYTES
+         * bytes, which are copied concurrently by the current thread and the (already
+         * attached) threads of the executor.
+         * When called from a task of the given executor, the copy is not split.
+         *
+         * @param context The context of the current thread.
+         * @param executor The executor performing the copy.
+         * @param offset The index of the first element to copy.
+         * @param elements The span in which to copy the elements.
+         *
+         * @throws JniException If the region is out of the bounds of this array.
+         */
+        void parallelCopyTo(const easyjni::JavaContext &context, easyjni::JavaExecutor &executor,
+                            int offset, std::span<T> elements) requires (!std::is_same_v<T, easyjni::JavaObject>) {
+            parallelCopy(context, executor, elements.size(),
+                         [=](const easyjni::JavaContext &ctx, JavaArray<T> target, std::size_t start, std::size_t count) {
+                             target.getRegion(ctx, offset + static_cast<int>(start), elements.subspan(start, count));
+                         });
+        }
+
+        /**
+         * Copies the elements of the given span into this array, starting at the
+         * given offset, splitting the copy among the threads of the given executor.
+         *
+         * @param executor The executor performing the copy.
+         * @param offset The index of the first element to set.
+         * @param elements The elements to copy into this array.
+         *
+         * @throws JniException If the region is out of the bounds of this array.
+         */
+        void parallelCopyFrom(easyjni::JavaExecutor &executor, int offset, std::span<const T> elements)
+                requires (!std::is_same_v<T, easyjni::JavaObject>) {
+            parallelCopyFrom(JavaVirtualMachineRegistry::getContext(), executor, offset, elements);
+        }
+
+        /**
+         * Copies the elements of the given span into this array, starting at the
+         * given offset, splitting the copy among the threads of the given executor,
+         * using the given context.
+         * When called from a task of the given executor, the copy is not split.
+         *
+         * @param context The context of the current thread.
+         * @param executor The executor performing the copy.
+         * @param offset The index of the first element to set.
+         * @param elements The elements to copy into this array.
+         *
+         * @throws JniException If the region is out of the bounds of this array.
+         */
+        void parallelCopyFrom(const easyjni::JavaContext &context, easyjni::JavaExecutor &executor,
+                              int offset, std::span<const T> elements)
+                requires (!std::is_same_v<T, easyjni::JavaObject>) {
+            parallelCopy(context, executor, elements.size(),
+                         [=](const easyjni::JavaContext &ctx, JavaArray<T> target, std::size_t start, std::size_t count) {
+                             target.setRegion(ctx, offset + static_cast<int>(start), elements.subspan(start, count));
+                         });
+        }
+
+        /**
+         * Gives a critical view of the elements of this array, which is the most
+         * likely to avoid copying them.
+         * No JNI call may be performed while the view is held.
+         *
+         * @return The critical view of the elements.
+         *
+         * @throws JniException If the elements could not be accessed.
+         */
+        easyjni::CriticalView<T> getCriticalView() requires (!std::is_same_v<T, easyjni::JavaObject>) {
+            return getCriticalView(JavaVirtualMachineRegistry::getContext());
+        }
+
+        /**
+         * Gives a critical view of the elements of this array, using the given context.
+         * No JNI call may be performed while the view is held.
+         *
+         * @param context The context of the current thread.
+         *
+         * @return The critical view of the elements.
+         *
+         * @throws JniException If the elements could not be accessed.
+         */
+        easyjni::CriticalView<T> getCriticalView(const easyjni::JavaContext &context)
+                requires (!std::is_same_v<T, easyjni::JavaObject>) {
+            return easyjni::CriticalView<T>(context, array);
+        }
+
+        /**
+         * Gives a critical view of the elements of this array, whose length is
+         * already known, using the given context.
+         * As no JNI call may be performed while a critical view is held (not even
+         * GetArrayLength()), this allows to acquire several critical views in a row.
+         *
+         * @param context The context of the current thread.
+         * @param length The length of this array, as given by length().
+         *
+         * @return The critical view of the elements.
+         *
+         * @throws JniException If the elements could not be accessed.
+         */
+        easyjni::CriticalView<T> getCriticalView(const easyjni::JavaContext &context, int length)
+                requires (!std::is_same_v<T, easyjni::JavaObject>) {
+            return easyjni::CriticalView<T>(context, array, static_cast<std::size_t>(length));
+        }
+
+        /**
+         * Gives a (non-critical) view of the elements of this array, which may be
+         * held for a long time.
+         *
+         * @return The view of the elements.
+         *
+         * @throws JniException If the elements could not be accessed.
+         */
+        easyjni::ElementsView<T> getElementsView() requires (!std::is_same_v<T, easyjni::JavaObject>) {
+            return getElementsView(JavaVirtualMachineRegistry::getContext());
+        }
+
+        /**
+         * Gives a (non-critical) view of the elements of this array, using the given
+         * context.
+         *
+         * @param context The context of the current thread.
+         *
+         * @return The view of the elements.
+         *
+         * @throws JniException If the elements could not be accessed.
+         */
+        easyjni::ElementsView<T> getElementsView(const easyjni::JavaContext &context)
+                requires (!std::is_same_v<T, easyjni::JavaObject>) {
+            return easyjni::ElementsView<T>(context, array);
+        }
+
+        /**
+         * Gives an iterator over the elements of this array, pointing to its first
+         * element.
+         * Elements of primitive arrays are read one chunk at a time.
+         *
+         * @return The iterator pointing to the first element.
+         */
+        easyjni::JavaArrayIterator<T> begin() {
+            return easyjni::JavaArrayIterator<T>(array, 0, length());
+        }
+
+        /**
+         * Gives an iterator pointing past the last element of this array.
+         *
+         * @return The iterator pointing past the last element.
+         */
+        easyjni::JavaArrayIterator<T> end() {
+            int len = length();
+            return easyjni::JavaArrayIterator<T>(array, len, len);
+        }
+
+        /**
+         * Applies a function to each element of this array, in order.
+         *
+         * @tparam Function The type of the function to apply.
+         *
+         * @param function The function to apply to each element.
+         *
+         * @throws JniException If the elements could not be read.
+         */
+        template<typename Function>
+        void forEach(Function function) {
+            forEach(JavaVirtualMachineRegistry::getContext(), function);
+        }
+
+        /**
+         * Applies a function to each element of this array, in order, using the
+         * given context.
+         * The elements of primitive arrays are read one chunk at a time.
+         * The elements of object arrays are read within a local frame that is
+         * released after each chunk, so that they are only valid while the
+         * function is applied to them.
+         *
+         * @tparam Function The type of the function to apply.
+         *
+         * @param context The context of the current thread.
+         * @param function The function to apply to each element.
+         *
+         * @throws JniException If the elements could not be read, and the context
+         *         checks exceptions immediately.
+         */
+        template<typename Function>
+        void forEach(const easyjni::JavaContext &context, Function function) {
+            constexpr int chunkSize = easyjni::JavaArrayIterator<T>::CHUNK_SIZE;
+            int len = length(context);
+
+            if constexpr (std::is_same_v<T, easyjni::JavaObject>) {
+                auto env = context.getEnvironment();
+                for (int start = 0; start < len; start += chunkSize) {
+                    int end = std::min(len, start + chunkSize);
+                    if (env->PushLocalFrame(end - start) < 0) {
+                        context.checkException();
+                        throw JniException("Could not allocate local references to iterate over an array");
+                    }
+                    try {
+                        for (int i = start; i < end; i++) {
+                            function(get(context, i));
+                        }
+                    } catch (...) {
+                        env->PopLocalFrame(nullptr);
+                        throw;
+                    }
+                    env->PopLocalFrame(nullptr);
+                }
+
+            } else {
+                std::array<T, static_cast<std::size_t>(chunkSize)> buffer;
+                for (int start = 0; start < len; start += chunkSize) {
+                    int size = std::min(chunkSize, len - start);
+                    getRegion(context, start, std::span<T>(buffer.data(), size));
+                    for (int i = 0; i < size; i++) {
+                        function(buffer[i]);
+                    }
+                }
+            }
+        }
+
+        /**
+         * Applies a function that may modify each element of this array, in order.
+         *
+         * @tparam Function The type of the function to apply, which takes a reference
+         *         to the element to modify.
+         *
+         * @param function The function to apply to each element.
+         *
+         * @throws JniException If the elements could not be read or written.
+         */
+        template<typename Function>
+        void update(Function function) requires (!std::is_same_v<T, easyjni::JavaObject>) {
+            update(JavaVirtualMachineRegistry::getContext(), function);
+        }
+
+        /**
+         * Applies a function that may modify each element of this array, in order,
+         * using the given context.
+         * The elements are read and written back one chunk at a time.
+         *
+         * @tparam Function The type of the function to apply, which takes a reference
+         *         to the element to modify.
+         *
+         * @param context The context of the current thread.
+         * @param function The function to apply to each element.
+         *
+         * @throws JniException If the elements could not be read or written, and the
+         *         context checks exceptions immediately.
+         */
+        template<typename Function>
+        void update(const easyjni::JavaContext &context, Function function)
+                requires (!std::is_same_v<T, easyjni::JavaObject>) {
+            constexpr int chunkSize = easyjni::JavaArrayIterator<T>::CHUNK_SIZE;
+            int len = length(context);
+            std::array<T, static_cast<std::size_t>(chunkSize)> buffer;
+            for (int start = 0; start < len; start += chunkSize) {
+                std::span<T> chunk(buffer.data(), std::min(chunkSize, len - start));
+                getRegion(context, start, chunk);
+                for (auto &elt : chunk) {
+                    function(elt);
+                }
+                setRegion(context, start, chunk);
+            }
+        }
+
         /**
          * Gives the native pointer to the array in the Java Virtual Machine.
          *
@@ -120,6 +571,76 @@ namespace easyjni {
             return array;
         }
 
+    private:
+
+        /**
+         * Splits a copy between this array and a C++ buffer among the current thread
+         * and the threads of an executor.
+         * When the current thread is itself a worker of the executor, the copy is
+         * performed by this thread only.
+         * As local references cannot be shared between threads, the threads of the
+         * executor access this array through a global reference.
+         *
+         * @tparam Copy The type of the function copying a region of the array.
+         *
+         * @param context The context of the current thread.
+         * @param executor The executor performing the copy.
+         * @param size The number of elements to copy.
+         * @param copy The function copying the region starting at a given index and
+         *        containing a given number of elements.
+         *
+         * @throws JniException If an error occurred while copying a region.
+         */
+        template<typename Copy>
+        void parallelCopy(const easyjni::JavaContext &context, easyjni::JavaExecutor &executor,
+                          std::size_t size, Copy copy) {
+            std::size_t minSize = std::max<std::size_t>(1, PARALLEL_COPY_MIN_BYTES / sizeof(T));
+            std::size_t nbParts = std::min(executor.size() + 1, size / minSize);
+            if ((nbParts <= 1) || executor.isWorkerThread()) {
+                // A worker waiting for tasks queued behind it could deadlock the executor.
+                copy(context, *this, 0, size);
+                return;
+            }
+
+            auto env = context.getEnvironment();
+            auto shared = static_cast<jarray>(env->NewGlobalRef(array));
+            if (shared == nullptr) {
+                context.checkException();
+                throw JniException("Could not share an array with the threads of an executor");
+            }
+
+            // The first region is copied by the current thread.
+            std::vector<std::future<void>> futures;
+            std::exception_ptr failure;
+            try {
+                futures.reserve(nbParts - 1);
+                for (std::size_t i = 1; i < nbParts; i++) {
+                    std::size_t start = size * i / nbParts;
+                    std::size_t end = size * (i + 1) / nbParts;
+                    futures.push_back(executor.submit([=](const easyjni::JavaContext &workerContext) {
+                        copy(workerContext, JavaArray<T>(shared), start, end - start);
+                    }));
+                }
+                copy(context, *this, 0, size / nbParts);
+            } catch (...) {
+                failure = std::current_exception();
+            }
+
+            // The global reference (and the C++ buffer) may only be released once
+            // all submitted regions are copied, even if a submission failed.
+            for (auto &future : futures) {
+                future.wait();
+            }
+            env->DeleteGlobalRef(shared);
+
+            if (failure) {
+                std::rethrow_exception(failure);
+            }
+            for (auto &future : futures) {
+                future.get();
+            }
+        }
+
         /**
          * The JavaVirtualMachine is a friend class, which allows to build instances
          * of JavaArray by creating arrays in the JVM.
@@ -132,6 +653,18 @@ namespace easyjni {
          */
         friend class JavaObject;
 
+        /**
+         * The JavaArrayIterator is a friend class, which reads the elements of the
+         * arrays over which it iterates.
+         */
+        friend class JavaArrayIterator<T>;
+
+        /**
+         * The JavaMatrix is a friend class, which reads and writes the elements of
+         * the rows it is made of.
+         */
+        template<typename U> requires (!std::is_same_v<U, easyjni::JavaObject>) friend class JavaMatrix;
+
     };
 
 }
@@ -0,0 +1,195 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#ifndef EASYJNI_JAVAARRAYALGORITHMS_H
+#define EASYJNI_JAVAARRAYALGORITHMS_H
+
+#include <cstddef>
+#include <span>
+
+#include <jni.h>
+
+#include "JavaArray.h"
+
+namespace easyjni {
+
+    /**
+     * The JavaArrayAlgorithms provides sorting and searching algorithms on the
+     * elements of primitive arrays (of any primitive type but boolean).
+     * The algorithms work in place, either on spans or directly on arrays of the
+     * Java Virtual Machine.
+     * Sorting arrays may take a while, and uses threads and temporary buffers:
+     * their elements are thus accessed through an ElementsView, which does not
+     * block the garbage collector.
+     * Searching an array only reads a few of its elements, which are thus accessed
+     * through a (short-lived) CriticalView.
+     *
+     * Elements are ordered as in java.util.Arrays: for floating point values,
+     * -0.0 comes before 0.0, and NaN comes after all other values.
+     * Large arrays are sorted in parallel, by sorting chunks of the array in
+     * different threads and then merging them.
+     *
+     * @author Romain Wallon
+     *
+     * @version 0.1.0
+     */
+    class JavaArrayAlgorithms {
+
+    public:
+
+        /**
+         * The minimum number of elements for an array to be sorted in parallel.
+         */
+        static constexpr std::size_t PARALLEL_THRESHOLD = 1 << 16;
+
+        /**
+         * Disables instantiation.
+         */
+        JavaArrayAlgorithms() = delete;
+
+        /**
+         * Sorts the given values in ascending order.
+         *
+         * @tparam T The type of the values.
+         *
+         * @param values The values to sort.
+         * @param nbThreads The maximum number of threads to use, or 0 to use as many
+         *        threads as there are hardware threads.
+         */
+        template<typename T>
+        static void sort(std::span<T> values, unsigned nbThreads = 0);
+
+        /**
+         * Sorts the given values in ascending order, preserving the order of equal values.
+         *
+         * @tparam T The type of the values.
+         *
+         * @param values The values to sort.
+         * @param nbThreads The maximum number of threads to use, or 0 to use as many
+         *        threads as there are hardware threads.
+         */
+        template<typename T>
+        static void stableSort(std::span<T> values, unsigned nbThreads = 0);
+
+        /**
+         * Partially sorts the given values, so that the value at index n is the one
+         * that would be there if the values were sorted, all the values before it are
+         * not greater, and all the values after it are not smaller.
+         *
+         * @tparam T The type of the values.
+         *
+         * @param values The values to partially sort.
+         * @param n The index of the value to put at its sorted position.
+         */
+        template<typename T>
+        static void nthElement(std::span<T> values, std::size_t n);
+
+        /**
+         * Searches for a value among sorted values.
+         *
+         * @tparam T The type of the values.
+         *
+         * @param values The sorted values in which to search.
+         * @param key The value to search for.
+         *
+         * @return The index of the key if it is found, or (-(insertion point) - 1)
+         *         otherwise, as in java.util.Arrays.binarySearch.
+         */
+        template<typename T>
+        static std::ptrdiff_t binarySearch(std::span<const T> values, T key);
+
+        /**
+         * Sorts the given array in ascending order.
+         *
+         * @tparam T The type of the elements in the array.
+         *
+         * @param array The array to sort.
+         * @param nbThreads The maximum number of threads to use, or 0 to use as many
+         *        threads as there are hardware threads.
+         *
+         * @throws JniException If the elements could not be accessed.
+         */
+        template<typename T>
+        static void sort(easyjni::JavaArray<T> array, unsigned nbThreads = 0) {
+            auto view = array.getElementsView();
+            sort(view.span(), nbThreads);
+        }
+
+        /**
+         * Sorts the given array in ascending order, preserving the order of equal
+         * elements.
+         *
+         * @tparam T The type of the elements in the array.
+         *
+         * @param array The array to sort.
+         * @param nbThreads The maximum number of threads to use, or 0 to use as many
+         *        threads as there are hardware threads.
+         *
+         * @throws JniException If the elements could not be accessed.
+         */
+        template<typename T>
+        static void stableSort(easyjni::JavaArray<T> array, unsigned nbThreads = 0) {
+            auto view = array.getElementsView();
+            stableSort(view.span(), nbThreads);
+        }
+
+        /**
+         * Partially sorts the given array, so that the element at index n is the one
+         * that would be there if the array was sorted.
+         *
+         * @tparam T The type of the elements in the array.
+         *
+         * @param array The array to partially sort.
+         * @param n The index of the element to put at its sorted position.
+         *
+         * @throws JniException If the elements could not be accessed.
+         */
+        template<typename T>
+        static void nthElement(easyjni::JavaArray<T> array, std::size_t n) {
+            auto view = array.getElementsView();
+            nthElement(view.span(), n);
+        }
+
+        /**
+         * Searches for a value in a sorted array.
+         *
+         * @tparam T The type of the elements in the array.
+         *
+         * @param array The sorted array in which to search.
+         * @param key The value to search for.
+         *
+         * @return The index of the key if it is found, or (-(insertion point) - 1)
+         *         otherwise, as in java.util.Arrays.binarySearch.
+         *
+         * @throws JniException If the elements could not be accessed.
+         */
+        template<typename T>
+        static std::ptrdiff_t binarySearch(easyjni::JavaArray<T> array, T key) {
+            auto view = array.getCriticalView();
+            auto index = binarySearch(std::span<const T>(view.span()), key);
+            view.release(ReleaseMode::ABORT);
+            return index;
+        }
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,253 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#ifndef EASYJNI_JAVAARRAYITERATOR_H
+#define EASYJNI_JAVAARRAYITERATOR_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <type_traits>
+
+#include <jni.h>
+
+#include "JavaVirtualMachineRegistry.h"
+
+namespace easyjni {
+
+    /**
+     * Forward declaration of JavaArray, the class representing the arrays over
+     * which a JavaArrayIterator iterates.
+     */
+    template<typename T>
+    class JavaArray;
+
+    /**
+     * Forward declaration of JavaObject, the class that represents an object
+     * from the Java Virtual Machine.
+     */
+    class JavaObject;
+
+    /**
+     * The JavaArrayIterator allows to read the elements of a JavaArray, e.g.,
+     * in range-based for loops or with standard algorithms.
+     * The elements of primitive arrays are read one chunk at a time into a buffer
+     * shared by the copies of the iterator, so that a single JNI call is performed
+     * per chunk, and copying an iterator remains cheap.
+     * The elements of object arrays are read one at a time, as JNI does not allow
+     * to read several of them at once.
+     * Each dereference of an iterator over an object array gives a new local
+     * reference, which is owned by the caller: as for get(), it remains valid
+     * until the current native method returns or the enclosing local frame is
+     * popped.
+     * Large object arrays should thus be iterated within local frames, or with
+     * JavaArray::forEach().
+     *
+     * @tparam T The type of the elements in the array.
+     *
+     * @author Romain Wallon
+     *
+     * @version 0.1.0
+     */
+    template<typename T>
+    class JavaArrayIterator {
+
+    public:
+
+        /**
+         * The number of elements read at once from primitive arrays.
+         */
+        static constexpr int CHUNK_SIZE = static_cast<int>(std::max<std::size_t>(1, 1024 / sizeof(T)));
+
+        /**
+         * The type of the elements read by this iterator.
+         */
+        using value_type = T;
+
+        /**
+         * The type of the difference between two iterators.
+         */
+        using difference_type = std::ptrdiff_t;
+
+        /**
+         * The type of the elements obtained when dereferencing this iterator,
+         * which are returned by value.
+         */
+        using reference = T;
+
+        /**
+         * The category of this iterator.
+         */
+        using iterator_category = std::input_iterator_tag;
+
+        /**
+         * The concept modeled by this iterator.
+         */
+        using iterator_concept = std::forward_iterator_tag;
+
+    private:
+
+        /**
+         * Whether the elements of the array are read one chunk at a time.
+         */
+        static constexpr bool BUFFERED = !std::is_same_v<T, easyjni::JavaObject>;
+
+        /**
+         * The Cache holds the chunk of elements of a primitive array that has been
+         * read last, and is shared by the copies of an iterator.
+         */
+        struct Cache {
+
+            /**
+             * The index of the first element in the cache, or -1 if the cache is empty.
+             */
+            int start = -1;
+
+            /**
+             * The elements of the current chunk.
+             */
+            std::array<T, static_cast<std::size_t>(CHUNK_SIZE)> elements {};
+
+        };
+
+        /**
+         * The native pointer to the array in the Java Virtual Machine.
+         */
+        jarray array;
+
+        /**
+         * The index of the element this iterator points to.
+         */
+        int index;
+
+        /**
+         * The length of the array.
+         */
+        int length;
+
+        /**
+         * The cache of the elements that have been read last, allocated when the
+         * first element of a primitive array is read.
+         */
+        mutable std::shared_ptr<Cache> cache;
+
+    public:
+
+        /**
+         * Creates a new JavaArrayIterator that does not point to any element.
+         */
+        JavaArrayIterator() :
+                array(nullptr),
+                index(0),
+                length(0),
+                cache() {
+            // Nothing to do: everything is already initialized.
+        }
+
+        /**
+         * Gives the element this iterator points to.
+         * This may read a new chunk of elements from the array.
+         * For object arrays, the returned object is a new local reference owned by
+         * the caller.
+         *
+         * @return The current element.
+         *
+         * @throws JniException If the element could not be read.
+         */
+        T operator*() const {
+            if constexpr (BUFFERED) {
+                if (cache == nullptr) {
+                    cache = std::make_shared<Cache>();
+                }
+                if ((cache->start < 0) || (index < cache->start) || (index >= cache->start + CHUNK_SIZE)) {
+                    auto size = static_cast<std::size_t>(std::min(CHUNK_SIZE, length - index));
+                    JavaArray<T>(array).getRegion(index, std::span<T>(cache->elements.data(), size));
+                    cache->start = index;
+                }
+                return cache->elements[static_cast<std::size_t>(index - cache->start)];
+
+            } else {
+                return JavaArray<T>(array).get(index);
+            }
+        }
+
+        /**
+         * Moves this iterator to the next element.
+         *
+         * @return This iterator.
+         */
+        JavaArrayIterator &operator++() {
+            index++;
+            return *this;
+        }
+
+        /**
+         * Moves this iterator to the next element.
+         *
+         * @return A copy of this iterator before it was moved.
+         */
+        JavaArrayIterator operator++(int) {
+            auto copy = *this;
+            index++;
+            return copy;
+        }
+
+        /**
+         * Checks whether this iterator points to the same element as another one.
+         *
+         * @param other The iterator to compare with.
+         *
+         * @return Whether the two iterators point to the same element.
+         */
+        bool operator==(const JavaArrayIterator &other) const {
+            return index == other.index;
+        }
+
+    private:
+
+        /**
+         * Creates a new JavaArrayIterator.
+         *
+         * @param array The native pointer to the array in the Java Virtual Machine.
+         * @param index The index of the element the iterator points to.
+         * @param length The length of the array.
+         */
+        JavaArrayIterator(jarray array, int index, int length) :
+                array(array),
+                index(index),
+                length(length),
+                cache() {
+            // Nothing to do: everything is already initialized.
+        }
+
+        /**
+         * The JavaArray is a friend class, which allows to create iterators
+         * over its elements.
+         */
+        friend class JavaArray<T>;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,470 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#ifndef EASYJNI_JAVAARRAYKERNELS_H
+#define EASYJNI_JAVAARRAYKERNELS_H
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#include <jni.h>
+
+#include "JavaArray.h"
+
+namespace easyjni {
+
+    /**
+     * The JavaArrayKernels provides vectorized operations on the elements of
+     * primitive arrays.
+     * The operations are performed in place, either on spans (such as those of
+     * the views of JavaArray) or directly on arrays of the Java Virtual Machine,
+     * which are then accessed through a CriticalView.
+     * The views of the arrays that are only read are released without copying
+     * back their elements.
+     *
+     * On x86 processors, the kernels are dispatched at runtime to the best
+     * instruction set supported by the processor (AVX-512, AVX2 or the SSE2
+     * baseline).
+     * Other processors use the portable implementation.
+     *
+     * Integer arithmetic wraps around, as it does in Java.
+     *
+     * @author Romain Wallon
+     *
+     * @version 0.1.0
+     */
+    class JavaArrayKernels {
+
+    public:
+
+        /**
+         * Disables instantiation.
+         */
+        JavaArrayKernels() = delete;
+
+        /**
+         * Gives the name of the instruction set used by the kernels on this processor.
+         *
+         * @return The name of the instruction set ("avx512", "avx2", "sse2" or "scalar").
+         */
+        static const char *getInstructionSet();
+
+        /**
+         * Computes the sum of the given values.
+         *
+         * @param values The values to sum.
+         *
+         * @return The sum of the values.
+         */
+        static jlong sum(std::span<const jbyte> values);
+
+        /**
+         * Computes the sum of the given values.
+         *
+         * @param values The values to sum.
+         *
+         * @return The sum of the values.
+         */
+        static jlong sum(std::span<const jshort> values);
+
+        /**
+         * Computes the sum of the given values.
+         *
+         * @param values The values to sum.
+         *
+         * @return The sum of the values.
+         */
+        static jlong sum(std::span<const jint> values);
+
+        /**
+         * Computes the sum of the given values.
+         *
+         * @param values The values to sum.
+         *
+         * @return The sum of the values.
+         */
+        static jlong sum(std::span<const jlong> values);
+
+        /**
+         * Computes the sum of the given values, accumulated in double precision.
+         *
+         * @param values The values to sum.
+         *
+         * @return The sum of the values.
+         */
+        static jdouble sum(std::span<const jfloat> values);
+
+        /**
+         * Computes the sum of the given values.
+         *
+         * @param values The values to sum.
+         *
+         * @return The sum of the values.
+         */
+        static jdouble sum(std::span<const jdouble> values);
+
+        /**
+         * Computes the minimum and maximum of the given values.
+         *
+         * @param values The values to consider.
+         *
+         * @return The minimum and maximum of the values, or the greatest and lowest
+         *         representable values if there is no value.
+         */
+        static std::pair<jbyte, jbyte> minMax(std::span<const jbyte> values);
+
+        /**
+         * Computes the minimum and maximum of the given values.
+         *
+         * @param values The values to consider.
+         *
+         * @return The minimum and maximum of the values, or the greatest and lowest
+         *         representable values if there is no value.
+         */
+        static std::pair<jshort, jshort> minMax(std::span<const jshort> values);
+
+        /**
+         * Computes the minimum and maximum of the given values.
+         *
+         * @param values The values to consider.
+         *
+         * @return The minimum and maximum of the values, or the greatest and lowest
+         *         representable values if there is no value.
+         */
+        static std::pair<jint, jint> minMax(std::span<const jint> values);
+
+        /**
+         * Computes the minimum and maximum of the given values.
+         *
+         * @param values The values to consider.
+         *
+         * @return The minimum and maximum of the values, or the greatest and lowest
+         *         representable values if there is no value.
+         */
+        static std::pair<jlong, jlong> minMax(std::span<const jlong> values);
+
+        /**
+         * Computes the minimum and maximum of the given values.
+         * As with Math.min() and Math.max(), both are NaN if any value is NaN.
+         *
+         * @param values The values to consider.
+         *
+         * @return The minimum and maximum of the values, or the greatest and lowest
+         *         representable values if there is no value.
+         */
+        static std::pair<jfloat, jfloat> minMax(std::span<const jfloat> values);
+
+        /**
+         * Computes the minimum and maximum of the given values.
+         * As with Math.min() and Math.max(), both are NaN if any value is NaN.
+         *
+         * @param values The values to consider.
+         *
+         * @return The minimum and maximum of the values, or the greatest and lowest
+         *         representable values if there is no value.
+         */
+        static std::pair<jdouble, jdouble> minMax(std::span<const jdouble> values);
+
+        /**
+         * Computes the dot product of two vectors.
+         *
+         * @param x The first vector.
+         * @param y The second vector.
+         *
+         * @return The dot product of the vectors.
+         *
+         * @throws JniException If the vectors do not have the same length.
+         */
+        static jlong dot(std::span<const jint> x, std::span<const jint> y);
+
+        /**
+         * Computes the dot product of two vectors.
+         *
+         * @param x The first vector.
+         * @param y The second vector.
+         *
+         * @return The dot product of the vectors.
+         *
+         * @throws JniException If the vectors do not have the same length.
+         */
+        static jfloat dot(std::span<const jfloat> x, std::span<const jfloat> y);
+
+        /**
+         * Computes the dot product of two vectors.
+         *
+         * @param x The first vector.
+         * @param y The second vector.
+         *
+         * @return The dot product of the vectors.
+         *
+         * @throws JniException If the vectors do not have the same length.
+         */
+        static jdouble dot(std::span<const jdouble> x, std::span<const jdouble> y);
+
+        /**
+         * Multiplies (in place) the given values by a factor.
+         *
+         * @param values The values to scale.
+         * @param factor The factor by which to multiply the values.
+         */
+        static void scale(std::span<jint> values, jint factor);
+
+        /**
+         * Multiplies (in place) the given values by a factor.
+         *
+         * @param values The values to scale.
+         * @param factor The factor by which to multiply the values.
+         */
+        static void scale(std::span<jlong> values, jlong factor);
+
+        /**
+         * Multiplies (in place) the given values by a factor.
+         *
+         * @param values The values to scale.
+         * @param factor The factor by which to multiply the values.
+         */
+        static void scale(std::span<jfloat> values, jfloat factor);
+
+        /**
+         * Multiplies (in place) the given values by a factor.
+         *
+         * @param values The values to scale.
+         * @param factor The factor by which to multiply the values.
+         */
+        static void scale(std::span<jdouble> values, jdouble factor);
+
+        /**
+         * Computes (in place) y = a * x + y.
+         *
+         * @param a The factor by which to multiply x.
+         * @param x The vector to add to y.
+         * @param y The vector to update.
+         *
+         * @throws JniException If the vectors do not have the same length.
+         */
+        static void axpy(jfloat a, std::span<const jfloat> x, std::span<jfloat> y);
+
+        /**
+         * Computes (in place) y = a * x + y.
+         *
+         * @param a The factor by which to multiply x.
+         * @param x The vector to add to y.
+         * @param y The vector to update.
+         *
+         * @throws JniException If the vectors do not have the same length.
+         */
+        static void axpy(jdouble a, std::span<const jdouble> x, std::span<jdouble> y);
+
+        /**
+         * Counts the occurrences of each byte value.
+         *
+         * @param bytes The bytes to count.
+         *
+         * @return The number of occurrences of each byte, indexed by its unsigned value.
+         */
+        static std::array<std::uint64_t, 256> histogram(std::span<const jbyte> bytes);
+
+        /**
+         * Computes the CRC-32 checksum of the given bytes, as java.util.zip.CRC32 does.
+         *
+         * @param bytes The bytes to checksum.
+         * @param crc The checksum of the previous bytes, if any.
+         *
+         * @return The checksum of the bytes.
+         */
+        static std::uint32_t crc32(std::span<const jbyte> bytes, std::uint32_t crc = 0);
+
+        /**
+         * Computes the 64-bit xxHash of the given bytes.
+         *
+         * @param bytes The bytes to hash.
+         * @param seed The seed of the hash.
+         *
+         * @return The hash of the bytes.
+         */
+        static std::uint64_t xxHash64(std::span<const jbyte> bytes, std::uint64_t seed = 0);
+
+        /**
+         * Computes the sum of the elements of the given array.
+         *
+         * @tparam T The type of the elements in the array.
+         *
+         * @param array The array to sum.
+         *
+         * @return The sum of the elements.
+         *
+         * @throws JniException If the elements could not be accessed.
+         */
+        template<typename T>
+        static auto sum(easyjni::JavaArray<T> array) {
+            auto view = array.getCriticalView();
+            auto result = sum(std::span<const T>(view.span()));
+            view.release(ReleaseMode::ABORT);
+            return result;
+        }
+
+        /**
+         * Computes the minimum and maximum of the elements of the given array.
+         *
+         * @tparam T The type of the elements in the array.
+         *
+         * @param array The array to consider.
+         *
+         * @return The minimum and maximum of the elements.
+         *
+         * @throws JniException If the elements could not be accessed.
+         */
+        template<typename T>
+        static std::pair<T, T> minMax(easyjni::JavaArray<T> array) {
+            auto view = array.getCriticalView();
+            auto result = minMax(std::span<const T>(view.span()));
+            view.release(ReleaseMode::ABORT);
+            return result;
+        }
+
+        /**
+         * Computes the dot product of two arrays.
+         *
+         * @tparam T The type of the elements in the arrays.
+         *
+         * @param x The first array.
+         * @param y The second array.
+         *
+         * @return The dot product of the arrays.
+         *
+         * @throws JniException If the elements could not be accessed, or if the arrays
+         *         do not have the same length.
+         */
+        template<typename T>
+        static auto dot(easyjni::JavaArray<T> x, easyjni::JavaArray<T> y) {
+            // No JNI call may be performed once the first critical view is held.
+            auto context = JavaVirtualMachineRegistry::getContext();
+            int length = x.length(context);
+            if (y.length(context) != length) {
+                throw JniException("Cannot compute the dot product of vectors of different lengths");
+            }
+            auto xView = x.getCriticalView(context, length);
+            auto yView = y.getCriticalView(context, length);
+            auto result = dot(std::span<const T>(xView.span()), std::span<const T>(yView.span()));
+            yView.release(ReleaseMode::ABORT);
+            xView.release(ReleaseMode::ABORT);
+            return result;
+        }
+
+        /**
+         * Multiplies (in place) the elements of the given array by a factor.
+         *
+         * @tparam T The type of the elements in the array.
+         *
+         * @param array The array to scale.
+         * @param factor The factor by which to multiply the elements.
+         *
+         * @throws JniException If the elements could not be accessed.
+         */
+        template<typename T>
+        static void scale(easyjni::JavaArray<T> array, T factor) {
+            auto view = array.getCriticalView();
+            scale(view.span(), factor);
+        }
+
+        /**
+         * Computes (in place) y = a * x + y on arrays.
+         *
+         * @tparam T The type of the elements in the arrays.
+         *
+         * @param a The factor by which to multiply x.
+         * @param x The array to add to y.
+         * @param y The array to update.
+         *
+         * @throws JniException If the elements could not be accessed, or if the arrays
+         *         do not have the same length.
+         */
+        template<typename T>
+        static void axpy(T a, easyjni::JavaArray<T> x, easyjni::JavaArray<T> y) {
+            // No JNI call may be performed once the first critical view is held.
+            auto context = JavaVirtualMachineRegistry::getContext();
+            int length = x.length(context);
+            if (y.length(context) != length) {
+                throw JniException("Cannot compute axpy on vectors of different lengths");
+            }
+            auto xView = x.getCriticalView(context, length);
+            auto yView = y.getCriticalView(context, length);
+            axpy(a, std::span<const T>(xView.span()), yView.span());
+            yView.release(ReleaseMode::COMMIT);
+            xView.release(ReleaseMode::ABORT);
+        }
+
+        /**
+         * Counts the occurrences of each byte value in the given array.
+         *
+         * @param array The array to consider.
+         *
+         * @return The number of occurrences of each byte, indexed by its unsigned value.
+         *
+         * @throws JniException If the elements could not be accessed.
+         */
+        static std::array<std::uint64_t, 256> histogram(easyjni::JavaArray<jbyte> array) {
+            auto view = array.getCriticalView();
+            auto result = histogram(std::span<const jbyte>(view.span()));
+            view.release(ReleaseMode::ABORT);
+            return result;
+        }
+
+        /**
+         * Computes the CRC-32 checksum of the given array, as java.util.zip.CRC32 does.
+         *
+         * @param array The array to checksum.
+         * @param crc The checksum of the previous bytes, if any.
+         *
+         * @return The checksum of the array.
+         *
+         * @throws JniException If the elements could not be accessed.
+         */
+        static std::uint32_t crc32(easyjni::JavaArray<jbyte> array, std::uint32_t crc = 0) {
+            auto view = array.getCriticalView();
+            auto result = crc32(std::span<const jbyte>(view.span()), crc);
+            view.release(ReleaseMode::ABORT);
+            return result;
+        }
+
+        /**
+         * Computes the 64-bit xxHash of the given array.
+         *
+         * @param array The array to hash.
+         * @param seed The seed of the hash.
+         *
+         * @return The hash of the array.
+         *
+         * @throws JniException If the elements could not be accessed.
+         */
+        static std::uint64_t xxHash64(easyjni::JavaArray<jbyte> array, std::uint64_t seed = 0) {
+            auto view = array.getCriticalView();
+            auto result = xxHash64(std::span<const jbyte>(view.span()), seed);
+            view.release(ReleaseMode::ABORT);
+            return result;
+        }
+
+    };
+
+}
+
+#endif
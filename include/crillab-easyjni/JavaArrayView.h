@@ -0,0 +1,396 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#ifndef EASYJNI_JAVAARRAYVIEW_H
+#define EASYJNI_JAVAARRAYVIEW_H
+
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include <jni.h>
+
+#include "JavaContext.h"
+#include "JniException.h"
+
+namespace easyjni {
+
+    /**
+     * Forward declaration of JavaArray, the class that represents an array in
+     * the Java Virtual Machine.
+     */
+    template<typename T>
+    class JavaArray;
+
+    /**
+     * The ReleaseMode defines what happens to the elements of a JavaArrayView
+     * when it is released.
+     */
+    enum class ReleaseMode {
+
+        /**
+         * The elements are copied back into the array (if they were copied),
+         * and the view is released.
+         */
+        COMMIT,
+
+        /**
+         * The elements are not copied back into the array (so that modifications
+         * performed on a copy are discarded), and the view is released.
+         */
+        ABORT
+
+    };
+
+    /**
+     * The JavaArrayView gives a direct access to the elements of a primitive array
+     * of the Java Virtual Machine, as a span.
+     * The Java Virtual Machine may either pin the array (so that the view is backed
+     * by the memory of the array itself), or give a copy of its elements.
+     * The elements are released (and copied back if needed) when the view is
+     * destroyed.
+     *
+     * Critical views use GetPrimitiveArrayCritical, which is the most likely to avoid
+     * a copy, but which is subject to strict rules: while the view is held, the
+     * current thread must not perform any JNI call, nor block.
+     * In debug builds, these rules are enforced through assertions.
+     * Non-critical views use Get<Type>ArrayElements, and may be held for longer.
+     *
+     * @tparam T The type of the elements in the array.
+     * @tparam Critical Whether the view is critical.
+     *
+     * @author Romain Wallon
+     *
+     * @version 0.1.0
+     */
+    template<typename T, bool Critical>
+    class JavaArrayView {
+
+    private:
+
+        /**
+         * The native Java Environment provided by JNI.
+         */
+        JNIEnv *env;
+
+        /**
+         * The native pointer to the array in the Java Virtual Machine.
+         */
+        jarray array;
+
+        /**
+         * The elements of the array, or nullptr if the view has been released.
+         */
+        T *elements;
+
+        /**
+         * The number of elements in the array.
+         */
+        std::size_t length;
+
+        /**
+         * Whether the elements have been copied by the Java Virtual Machine.
+         */
+        bool copy;
+
+    private:
+
+        /**
+         * Creates a new JavaArrayView.
+         *
+         * @param context The context of the current thread.
+         * @param array The native pointer to the array in the Java Virtual Machine.
+         *
+         * @throws JniException If the elements of the array could not be accessed.
+         */
+        JavaArrayView(const easyjni::JavaContext &context, jarray array) :
+                JavaArrayView(context, array, static_cast<std::size_t>(context.env->GetArrayLength(array))) {
+            // Nothing to do: everything is already initialized.
+        }
+
+        /**
+         * Creates a new JavaArrayView on an array whose length is already known.
+         *
+         * @param context The context of the current thread.
+         * @param array The native pointer to the array in the Java Virtual Machine.
+         * @param length The number of elements in the array.
+         *
+         * @throws JniException If the elements of the array could not be accessed.
+         */
+        JavaArrayView(const easyjni::JavaContext &context, jarray array, std::size_t length) :
+                env(context.env),
+                array(array),
+                elements(nullptr),
+                length(length),
+                copy(false) {
+            jboolean isCopy = JNI_FALSE;
+            elements = acquire(&isCopy);
+            if (elements == nullptr) {
+                context.checkException();
+                throw JniException("Could not access the elements of an array");
+            }
+            copy = (isCopy == JNI_TRUE);
+
+#ifndef NDEBUG
+            if constexpr (Critical) {
+                easyjni::JavaContext::criticalRegions++;
+            }
+#endif
+        }
+
+    public:
+
+        /**
+         * Disables the copy of JavaArrayView instances.
+         */
+        JavaArrayView(const JavaArrayView &) = delete;
+
+        /**
+         * Moves a JavaArrayView.
+         *
+         * @param other The view to move.
+         */
+        JavaArrayView(JavaArrayView &&other) noexcept :
+                env(other.env),
+                array(other.array),
+                elements(std::exchange(other.elements, nullptr)),
+                length(other.length),
+                copy(other.copy) {
+            // Nothing to do: everything is already initialized.
+        }
+
+        /**
+         * Disables the assignment of JavaArrayView instances.
+         */
+        JavaArrayView &operator=(const JavaArrayView &) = delete;
+
+        /**
+         * Destroys this JavaArrayView, and releases the elements (copying them
+         * back into the array if needed).
+         */
+        ~JavaArrayView() {
+            release(ReleaseMode::COMMIT);
+        }
+
+        /**
+         * Gives the elements of the array as a span.
+         *
+         * @return The span of the elements.
+         */
+        [[nodiscard]] std::span<T> span() const {
+            return {elements, length};
+        }
+
+        /**
+         * Gives a pointer to the elements of the array.
+         *
+         * @return The pointer to the elements.
+         */
+        [[nodiscard]] T *data() const {
+            return elements;
+        }
+
+        /**
+         * Gives the number of elements in the array.
+         *
+         * @return The number of elements.
+         */
+        [[nodiscard]] std::size_t size() const {
+            return length;
+        }
+
+        /**
+         * Gives the element at the given index.
+         *
+         * @param index The index of the element.
+         *
+         * @return The element at the given index.
+         */
+        T &operator[](std::size_t index) const {
+            return elements[index];
+        }
+
+        /**
+         * Gives an iterator to the first element of the array.
+         *
+         * @return The iterator to the first element.
+         */
+        [[nodiscard]] T *begin() const {
+            return elements;
+        }
+
+        /**
+         * Gives an iterator past the last element of the array.
+         *
+         * @return The iterator past the last element.
+         */
+        [[nodiscard]] T *end() const {
+            return elements + length;
+        }
+
+        /**
+         * Checks whether the Java Virtual Machine has copied the elements of the
+         * array, rather than pinning it.
+         * In this case, modifications are only visible in the array once the view
+         * has been committed or released.
+         *
+         * @return Whether the elements have been copied.
+         */
+        [[nodiscard]] bool isCopy() const {
+            return copy;
+        }
+
+        /**
+         * Copies back the elements into the array (if they were copied), without
+         * releasing this view.
+         */
+        void commit() {
+            if ((elements != nullptr) && copy) {
+                releaseElements(JNI_COMMIT);
+            }
+        }
+
+        /**
+         * Releases this view.
+         * The view must not be used after having been released.
+         *
+         * @param mode Whether the elements must be copied back into the array.
+         */
+        void release(ReleaseMode mode = ReleaseMode::COMMIT) {
+            if (elements == nullptr) {
+                return;
+            }
+
+            releaseElements((mode == ReleaseMode::COMMIT) ? 0 : JNI_ABORT);
+            elements = nullptr;
+
+#ifndef NDEBUG
+            if constexpr (Critical) {
+                easyjni::JavaContext::criticalRegions--;
+            }
+#endif
+        }
+
+    private:
+
+        /**
+         * Acquires the elements of the array.
+         *
+         * @param isCopy The pointer in which to store whether the elements are copied.
+         *
+         * @return The elements of the array.
+         */
+        T *acquire(jboolean *isCopy) {
+            if constexpr (Critical) {
+                return static_cast<T *>(env->GetPrimitiveArrayCritical(array, isCopy));
+
+            } else if constexpr (std::is_same_v<T, jboolean>) {
+                return env->GetBooleanArrayElements(static_cast<jbooleanArray>(array), isCopy);
+
+            } else if constexpr (std::is_same_v<T, jbyte>) {
+                return env->GetByteArrayElements(static_cast<jbyteArray>(array), isCopy);
+
+            } else if constexpr (std::is_same_v<T, jchar>) {
+                return env->GetCharArrayElements(static_cast<jcharArray>(array), isCopy);
+
+            } else if constexpr (std::is_same_v<T, jshort>) {
+                return env->GetShortArrayElements(static_cast<jshortArray>(array), isCopy);
+
+            } else if constexpr (std::is_same_v<T, jint>) {
+                return env->GetIntArrayElements(static_cast<jintArray>(array), isCopy);
+
+            } else if constexpr (std::is_same_v<T, jlong>) {
+                return env->GetLongArrayElements(static_cast<jlongArray>(array), isCopy);
+
+            } else if constexpr (std::is_same_v<T, jfloat>) {
+                return env->GetFloatArrayElements(static_cast<jfloatArray>(array), isCopy);
+
+            } else {
+                static_assert(std::is_same_v<T, jdouble>, "Only primitive arrays can be viewed");
+                return env->GetDoubleArrayElements(static_cast<jdoubleArray>(array), isCopy);
+            }
+        }
+
+        /**
+         * Releases the elements of the array.
+         *
+         * @param mode The JNI release mode (0, JNI_COMMIT or JNI_ABORT).
+         */
+        void releaseElements(jint mode) {
+            if constexpr (Critical) {
+                env->ReleasePrimitiveArrayCritical(array, elements, mode);
+
+            } else if constexpr (std::is_same_v<T, jboolean>) {
+                env->ReleaseBooleanArrayElements(static_cast<jbooleanArray>(array), elements, mode);
+
+            } else if constexpr (std::is_same_v<T, jbyte>) {
+                env->ReleaseByteArrayElements(static_cast<jbyteArray>(array), elements, mode);
+
+            } else if constexpr (std::is_same_v<T, jchar>) {
+                env->ReleaseCharArrayElements(static_cast<jcharArray>(array), elements, mode);
+
+            } else if constexpr (std::is_same_v<T, jshort>) {
+                env->ReleaseShortArrayElements(static_cast<jshortArray>(array), elements, mode);
+
+            } else if constexpr (std::is_same_v<T, jint>) {
+                env->ReleaseIntArrayElements(static_cast<jintArray>(array), elements, mode);
+
+            } else if constexpr (std::is_same_v<T, jlong>) {
+                env->ReleaseLongArrayElements(static_cast<jlongArray>(array), elements, mode);
+
+            } else if constexpr (std::is_same_v<T, jfloat>) {
+                env->ReleaseFloatArrayElements(static_cast<jfloatArray>(array), elements, mode);
+
+            } else {
+                env->ReleaseDoubleArrayElements(static_cast<jdoubleArray>(array), elements, mode);
+            }
+        }
+
+        /**
+         * The JavaArray is a friend class, which creates the views of its elements.
+         */
+        friend class JavaArray<T>;
+
+    };
+
+    /**
+     * The CriticalView gives a direct access to the elements of a primitive array,
+     * through GetPrimitiveArrayCritical.
+     * No JNI call may be performed while it is held.
+     *
+     * @tparam T The type of the elements in the array.
+     */
+    template<typename T>
+    using CriticalView = easyjni::JavaArrayView<T, true>;
+
+    /**
+     * The ElementsView gives a direct access to the elements of a primitive array,
+     * through Get<Type>ArrayElements.
+     * It may be held for longer than a CriticalView.
+     *
+     * @tparam T The type of the elements in the array.
+     */
+    template<typename T>
+    using ElementsView = easyjni::JavaArrayView<T, false>;
+
+}
+
+#endif
@@ -0,0 +1,424 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#ifndef EASYJNI_JAVABULKDISPATCHER_H
+#define EASYJNI_JAVABULKDISPATCHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <jni.h>
+
+#include "JavaArguments.h"
+#include "JavaClass.h"
+#include "JavaContext.h"
+#include "JavaMethod.h"
+#include "JavaObject.h"
+#include "JniException.h"
+
+namespace easyjni {
+
+    /**
+     * The JavaSlot identifies a slot of a JavaBulkDispatcher, i.e., an object
+     * shared between the C++ side and the calls of a batch.
+     */
+    struct JavaSlot {
+
+        /**
+         * The index of the slot, or -1 for the null slot.
+         */
+        std::int32_t index;
+
+    };
+
+    /**
+     * The JavaBulkDispatcher records method invocations, and executes them all in
+     * a single downcall to the Java Virtual Machine, which amortizes the cost of
+     * JNI transitions for chatty workloads (such as building object graphs).
+     * Calls are packed into a buffer that is decoded by a helper class which is
+     * embedded in EasyJNI and defined when the Java Virtual Machine is created.
+     *
+     * Objects are shared between the C++ side and the recorded calls through
+     * slots: the result of a call is stored in a slot, which may be used as the
+     * receiver or as an argument of subsequent calls.
+     * Primitive values, strings and slots are packed without any JNI call.
+     * Objects coming from the C++ side, on the other hand, are stored into their
+     * slot with one JNI call each, when they are bound (or given as arguments),
+     * as JNI cannot store several objects into an array at once.
+     * Objects used by several calls should thus be bound once, and then referred
+     * to by their slot.
+     *
+     * A JavaBulkDispatcher must only be used by the thread that created it.
+     *
+     * @author Romain Wallon
+     *
+     * @version 0.1.0
+     */
+    class JavaBulkDispatcher {
+
+    public:
+
+        /**
+         * The (internal) name of the helper class used to dispatch the calls.
+         */
+        static constexpr const char *CLASS_NAME = "fr/univartois/cril/easyjni/BulkDispatcher";
+
+    private:
+
+        /**
+         * The helper class used to dispatch the calls.
+         */
+        easyjni::JavaClass dispatcherClass;
+
+        /**
+         * The method executing a batch of calls.
+         */
+        easyjni::JavaMethod<void *> dispatchMethod;
+
+        /**
+         * The method preparing a target to be invoked, by creating its method handle.
+         */
+        easyjni::JavaMethod<easyjni::JavaObject> prepareMethod;
+
+        /**
+         * The method releasing the objects held by the slots.
+         */
+        easyjni::JavaMethod<void *> clearMethod;
+
+        /**
+         * The (global reference to the) array holding the objects stored in the slots.
+         */
+        jobjectArray slots;
+
+        /**
+         * The number of slots.
+         */
+        std::int32_t nbSlots;
+
+        /**
+         * The number of slots that are currently in use.
+         */
+        std::int32_t nbUsedSlots;
+
+        /**
+         * The (global references to the) method handles invoking the methods and
+         * constructors that may be called.
+         */
+        std::vector<jobject> targets;
+
+        /**
+         * The index of each target, identified by its method ID.
+         */
+        std::unordered_map<jmethodID, std::int32_t> targetIndices;
+
+        /**
+         * The (global reference to the) array of targets, as given to the helper class.
+         * It is rebuilt when new targets are recorded.
+         */
+        jobjectArray targetArray;
+
+        /**
+         * The packed calls that have not been executed yet.
+         */
+        std::vector<unsigned char> calls;
+
+        /**
+         * The number of calls that have not been executed yet.
+         */
+        std::size_t nbCalls;
+
+    public:
+
+        /**
+         * Creates a new JavaBulkDispatcher.
+         *
+         * @param nbSlots The number of objects that can be shared with the calls.
+         *
+         * @throws JniException If the dispatcher could not be created.
+         */
+        explicit JavaBulkDispatcher(std::int32_t nbSlots = 1024);
+
+        /**
+         * Disables the copy of JavaBulkDispatcher instances.
+         */
+        JavaBulkDispatcher(const easyjni::JavaBulkDispatcher &) = delete;
+
+        /**
+         * Disables the copy of JavaBulkDispatcher instances.
+         */
+        easyjni::JavaBulkDispatcher &operator=(const easyjni::JavaBulkDispatcher &) = delete;
+
+        /**
+         * Destroys this JavaBulkDispatcher, and releases the references it holds.
+         * Calls that have not been executed yet are discarded.
+         */
+        ~JavaBulkDispatcher();
+
+        /**
+         * Stores an object in a new slot, so that it can be used by the calls.
+         * This performs a JNI call, and is thus not amortized over the batch.
+         *
+         * @param object The object to store.
+         *
+         * @return The slot in which the object is stored.
+         *
+         * @throws JniException If there is no more slots available.
+         */
+        JavaSlot bind(easyjni::JavaObject object);
+
+        /**
+         * Gives the object stored in the given slot.
+         * Note that the result of a call is only available once the calls have
+         * been executed.
+         *
+         * @param slot The slot to read.
+         *
+         * @return The object stored in the slot.
+         */
+        easyjni::JavaObject get(JavaSlot slot);
+
+        /**
+         * Records the invocation of a method on the object stored in a slot.
+         *
+         * @tparam T The return type of the method.
+         * @tparam Args The types of the parameters to give to the method.
+         *
+         * @param clazz The class declaring the method.
+         * @param method The method to invoke.
+         * @param receiver The slot storing the object on which to invoke the method.
+         * @param args The parameters to give to the method.
+         *
+         * @return The slot in which the (boxed) result of the method will be stored,
+         *         or the null slot if the method returns void.
+         *
+         * @throws JniException If the method could not be recorded.
+         */
+        template<typename T, typename... Args>
+        JavaSlot invoke(easyjni::JavaClass clazz, easyjni::JavaMethod<T> method, JavaSlot receiver, Args &&... args) {
+            if (method.constructor) {
+                throw JniException("Cannot invoke a constructor on an instance");
+            }
+
+            auto target = targetOf(*clazz, method.nativeMethod, false);
+            return record<T>(target, receiver, std::forward<Args>(args)...);
+        }
+
+        /**
+         * Records the invocation of a static method, or of a constructor.
+         *
+         * @tparam T The return type of the method.
+         * @tparam Args The types of the parameters to give to the method.
+         *
+         * @param clazz The class declaring the method.
+         * @param method The method to invoke.
+         * @param args The parameters to give to the method.
+         *
+         * @return The slot in which the (boxed) result of the method will be stored,
+         *         or the null slot if the method returns void.
+         *
+         * @throws JniException If the method could not be recorded.
+         */
+        template<typename T, typename... Args>
+        JavaSlot invokeStatic(easyjni::JavaClass clazz, easyjni::JavaMethod<T> method, Args &&... args) {
+            auto target = targetOf(*clazz, method.nativeMethod, !method.constructor);
+            return record<T>(target, JavaSlot{-1}, std::forward<Args>(args)...);
+        }
+
+        /**
+         * Gives the number of calls that have not been executed yet.
+         *
+         * @return The number of pending calls.
+         */
+        [[nodiscard]] std::size_t size() const {
+            return nbCalls;
+        }
+
+        /**
+         * Executes, in a single downcall, all the calls recorded so far.
+         *
+         * @throws JniException If one of the calls failed.
+         */
+        void flush();
+
+        /**
+         * Executes, in a single downcall, all the calls recorded so far, using the
+         * given context.
+         * If a call fails, the subsequent calls are not executed.
+         *
+         * @param context The context of the current thread.
+         *
+         * @throws JniException If one of the calls failed, and the context checks
+         *         exceptions immediately.
+         */
+        void flush(const easyjni::JavaContext &context);
+
+        /**
+         * Releases all the slots, so that they can be reused.
+         * Calls that have not been executed yet are discarded.
+         */
+        void reset();
+
+    private:
+
+        /**
+         * Gives the index of the given target, recording it if needed.
+         *
+         * @param clazz The class declaring the target.
+         * @param method The method to invoke.
+         * @param isStatic Whether the method is static.
+         *
+         * @return The index of the target.
+         *
+         * @throws JniException If the target could not be recorded.
+         */
+        std::int32_t targetOf(jclass clazz, jmethodID method, bool isStatic);
+
+        /**
+         * Reserves a new slot.
+         *
+         * @return The reserved slot.
+         *
+         * @throws JniException If there is no more slots available.
+         */
+        JavaSlot newSlot();
+
+        /**
+         * Records a call.
+         *
+         * @tparam T The return type of the method.
+         * @tparam Args The types of the parameters to give to the method.
+         *
+         * @param target The index of the method to invoke.
+         * @param receiver The slot storing the object on which to invoke the method.
+         * @param args The parameters to give to the method.
+         *
+         * @return The slot in which the result of the method will be stored.
+         */
+        template<typename T, typename... Args>
+        JavaSlot record(std::int32_t target, JavaSlot receiver, Args &&... args) {
+            JavaSlot result = std::is_same_v<T, void *> ? JavaSlot{-1} : newSlot();
+            write(target);
+            write(receiver.index);
+            write(result.index);
+            write(static_cast<std::int32_t>(sizeof...(Args)));
+            (encode(std::forward<Args>(args)), ...);
+            nbCalls++;
+            return result;
+        }
+
+        /**
+         * Packs a tagged argument of a call.
+         *
+         * @tparam A The type of the argument.
+         *
+         * @param arg The argument to pack.
+         */
+        template<typename A>
+        void encode(A &&arg) {
+            using Type = std::decay_t<A>;
+            if constexpr (std::is_same_v<Type, bool> || std::is_same_v<Type, jboolean>) {
+                tag('Z', static_cast<jboolean>(arg ? JNI_TRUE : JNI_FALSE));
+
+            } else if constexpr (std::is_same_v<Type, jbyte>) {
+                tag('B', arg);
+
+            } else if constexpr (std::is_same_v<Type, jchar>) {
+                tag('C', arg);
+
+            } else if constexpr (std::is_same_v<Type, jshort>) {
+                tag('S', arg);
+
+            } else if constexpr (std::is_same_v<Type, jint>) {
+                tag('I', arg);
+
+            } else if constexpr (std::is_same_v<Type, jlong> || std::is_same_v<Type, long long>) {
+                tag('J', static_cast<jlong>(arg));
+
+            } else if constexpr (std::is_same_v<Type, jfloat>) {
+                tag('F', arg);
+
+            } else if constexpr (std::is_same_v<Type, jdouble>) {
+                tag('D', arg);
+
+            } else if constexpr (std::is_same_v<Type, JavaSlot>) {
+                tag('L', arg.index);
+
+            } else if constexpr (std::is_same_v<Type, std::nullptr_t>) {
+                tag('L', static_cast<std::int32_t>(-1));
+
+            } else if constexpr (std::is_same_v<Type, easyjni::JavaObject>) {
+                tag('L', bind(arg).index);
+
+            } else if constexpr (std::is_convertible_v<Type, std::string_view>) {
+                std::string_view str(arg);
+                tag('T', static_cast<std::int32_t>(str.size()));
+                calls.insert(calls.end(), str.begin(), str.end());
+
+            } else {
+                static_assert(alwaysFalse<Type>, "Unsupported argument type");
+            }
+        }
+
+        /**
+         * Packs a tagged value.
+         *
+         * @tparam V The type of the value.
+         *
+         * @param type The tag identifying the type of the value.
+         * @param value The value to pack.
+         */
+        template<typename V>
+        void tag(char type, V value) {
+            calls.push_back(static_cast<unsigned char>(type));
+            write(value);
+        }
+
+        /**
+         * Packs a value, in native byte order.
+         *
+         * @tparam V The type of the value.
+         *
+         * @param value The value to pack.
+         */
+        template<typename V>
+        void write(V value) {
+            auto bytes = reinterpret_cast<const unsigned char *>(&value);
+            calls.insert(calls.end(), bytes, bytes + sizeof(V));
+        }
+
+        /**
+         * Rebuilds the array of targets given to the helper class, if new targets
+         * have been recorded since it has been built.
+         *
+         * @param env The environment of the current thread.
+         */
+        void updateTargetArray(JNIEnv *env);
+
+    };
+
+}
+
+#endif
@@ -21,6 +21,14 @@
 #ifndef EASYJNI_JAVACLASS_H
 #define EASYJNI_JAVACLASS_H
 
+#include <cstddef>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
 #include <jni.h>
 
 #include "JavaElement.h"
@@ -45,6 +53,42 @@ namespace easyjni {
      */
     template<typename T> class JavaMethod;
 
+    /**
+     * The JavaClassMetadata describes the type of a Java class.
+     * It is computed once per class, and then cached.
+     */
+    struct JavaClassMetadata {
+
+        /**
+         * The (binary) name of the class, as given by Class.getName().
+         */
+        std::string name;
+
+        /**
+         * The canonical name of the class, or an empty string if the class does
+         * not have a canonical name.
+         */
+        std::string canonicalName;
+
+        /**
+         * Whether the class represents an array type.
+         */
+        bool array;
+
+        /**
+         * The (binary) name of the component type of the class if it represents
+         * an array type, or an empty string otherwise.
+         */
+        std::string componentType;
+
+        /**
+         * The (binary) names of the superclasses of the class, from its direct
+         * superclass up to java.lang.Object.
+         */
+        std::vector<std::string> superclasses;
+
+    };
+
     /**
      * The JavaClass represents a Java class extracted from the Java Virtual Machine.
      *
@@ -61,6 +105,51 @@ namespace easyjni {
          */
         jclass nativeClass;
 
+        /**
+         * The CachedMetadata associates the metadata of a class with a weak global
+         * reference to this class, which identifies it.
+         */
+        struct CachedMetadata {
+
+            /**
+             * The weak global reference to the described class.
+             */
+            jweak nativeClass;
+
+            /**
+             * The metadata of the class.
+             */
+            std::shared_ptr<const easyjni::JavaClassMetadata> metadata;
+
+        };
+
+        /**
+         * The metadata of the classes that have already been described, indexed
+         * by the binary name of these classes.
+         * As different class loaders may define classes with the same name, the
+         * classes are identified by their reference.
+         * The classes whose name is unknown are thus looked up by reference only,
+         * without calling Java code.
+         */
+        static std::unordered_multimap<std::string, CachedMetadata> metadataCache;
+
+        /**
+         * The minimum size of the metadata cache from which the metadata of the
+         * classes that have been unloaded are removed.
+         */
+        static constexpr std::size_t MIN_METADATA_PRUNE_SIZE = 64;
+
+        /**
+         * The size of the metadata cache from which the metadata of the classes
+         * that have been unloaded are removed.
+         */
+        static std::size_t metadataPruneSize;
+
+        /**
+         * The mutex used to avoid concurrent accesses to the metadata cache.
+         */
+        static std::shared_mutex metadataMutex;
+
     private:
 
         /**
@@ -87,6 +176,17 @@ namespace easyjni {
          */
         easyjni::JavaObject asObject();
 
+        /**
+         * Gives the metadata describing this class.
+         * The metadata of a class is only computed once, and then cached (this
+         * includes the classes obtained with JavaObject::getClass()).
+         *
+         * @return The metadata of this class.
+         *
+         * @throws JniException If an error occurred while computing the metadata.
+         */
+        std::shared_ptr<const easyjni::JavaClassMetadata> getMetadata();
+
         /**
          * Checks whether this class represents an array type.
          *
@@ -603,6 +703,78 @@ namespace easyjni {
         easyjni::JavaMethod<easyjni::JavaObject> getStaticObjectMethod(
                 const std::string &name, const std::string &signature = METHOD(CLASS(java/lang/Object)));
 
+        /**
+         * Gives the field defined in this class with the given name, the signature of
+         * which is computed at compile-time from its type.
+         *
+         * @tparam T The C++ type of the field, as in getField<jint>("count").
+         *
+         * @param name The name of the field to get.
+         *
+         * @return The field of this class with the given name and type.
+         *
+         * @throws JniException If an error occurred while getting the field.
+         */
+        template<typename T>
+        easyjni::JavaField<typename easyjni::Signature<T>::Type> getField(const std::string &name) {
+            jfieldID field = getFieldID(name, easyjni::Signature<T>::value);
+            return easyjni::JavaField<typename easyjni::Signature<T>::Type>::newInstance(name, field);
+        }
+
+        /**
+         * Gives the static field defined in this class with the given name, the
+         * signature of which is computed at compile-time from its type.
+         *
+         * @tparam T The C++ type of the field, as in getStaticField<JString>("NAME").
+         *
+         * @param name The name of the field to get.
+         *
+         * @return The static field of this class with the given name and type.
+         *
+         * @throws JniException If an error occurred while getting the field.
+         */
+        template<typename T>
+        easyjni::JavaField<typename easyjni::Signature<T>::Type> getStaticField(const std::string &name) {
+            jfieldID field = getStaticFieldID(name, easyjni::Signature<T>::value);
+            return easyjni::JavaField<typename easyjni::Signature<T>::Type>::newInstance(name, field);
+        }
+
+        /**
+         * Gives the method defined in this class with the given name, the signature
+         * of which is computed at compile-time from its function type.
+         *
+         * @tparam F The C++ function type of the method, as in getMethod<void(jint, JString)>("run").
+         *
+         * @param name The name of the method to get.
+         *
+         * @return The method of this class with the given name and type.
+         *
+         * @throws JniException If an error occurred while getting the method.
+         */
+        template<typename F>
+        easyjni::JavaMethod<typename easyjni::Signature<F>::Type> getMethod(const std::string &name) {
+            jmethodID method = getMethodID(name, easyjni::Signature<F>::value);
+            return easyjni::JavaMethod<typename easyjni::Signature<F>::Type>::newInstance(name, method);
+        }
+
+        /**
+         * Gives the static method defined in this class with the given name, the
+         * signature of which is computed at compile-time from its function type.
+         *
+         * @tparam F The C++ function type of the method, as in getStaticMethod<jint(jint, jint)>("max").
+         *
+         * @param name The name of the method to get.
+         *
+         * @return The static method of this class with the given name and type.
+         *
+         * @throws JniException If an error occurred while getting the method.
+         */
+        template<typename F>
+        easyjni::JavaMethod<typename easyjni::Signature<F>::Type> getStaticMethod(const std::string &name) {
+            jmethodID method = getStaticMethodID(name, easyjni::Signature<F>::value);
+            return easyjni::JavaMethod<typename easyjni::Signature<F>::Type>::newInstance(name, method);
+        }
+
     private:
 
         /**
@@ -616,7 +788,7 @@ namespace easyjni {
          *
          * @throws JniException If an error occurred while getting the field.
          */
-        jfieldID getFieldID(const std::string &name, const std::string &signature);
+        jfieldID getFieldID(const std::string &name, const char *signature);
 
         /**
          * Gives the native static field with the given name and signature that is
@@ -629,7 +801,7 @@ namespace easyjni {
          *
          * @throws JniException If an error occurred while getting the field.
          */
-        jfieldID getStaticFieldID(const std::string &name, const std::string &signature);
+        jfieldID getStaticFieldID(const std::string &name, const char *signature);
 
         /**
          * Gives the native method with the given name and signature that is declared
@@ -642,7 +814,7 @@ namespace easyjni {
          *
          * @throws JniException If an error occurred while getting the method.
          */
-        jmethodID getMethodID(const std::string &name, const std::string &signature);
+        jmethodID getMethodID(const std::string &name, const char *signature);
 
         /**
          * Gives the native static method with the given name and signature that is
@@ -655,7 +827,31 @@ namespace easyjni {
          *
          * @throws JniException If an error occurred while getting the method.
          */
-        jmethodID getStaticMethodID(const std::string &name, const std::string &signature);
+        jmethodID getStaticMethodID(const std::string &name, const char *signature);
+
+        /**
+         * Gives the binary name of this class, as given by Class.getName().
+         * This name is derived from the name of this class, which must be known.
+         *
+         * @return The binary name of this class.
+         */
+        std::string getBinaryName();
+
+        /**
+         * Computes the metadata describing this class, by reflection.
+         *
+         * @return The metadata of this class.
+         *
+         * @throws JniException If an error occurred while computing the metadata.
+         */
+        easyjni::JavaClassMetadata computeMetadata();
+
+        /**
+         * Removes the metadata of all classes from the metadata cache.
+         *
+         * @param env The environment used to delete the references to the classes.
+         */
+        static void clearMetadataCache(JNIEnv *env);
 
         /**
          * The JavaVirtualMachine is a friend class, which allows to load
@@ -671,6 +867,11 @@ namespace easyjni {
 
     };
 
+    /**
+     * JavaClass is passed by value to static invocations, so copying it must remain cheap.
+     */
+    static_assert(std::is_trivially_copyable_v<easyjni::JavaClass>, "Java class handles must be trivially copyable");
+
 }
 
 #endif
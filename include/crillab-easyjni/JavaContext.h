@@ -0,0 +1,181 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#ifndef EASYJNI_JAVACONTEXT_H
+#define EASYJNI_JAVACONTEXT_H
+
+#include <cassert>
+
+#include <jni.h>
+
+namespace easyjni {
+
+    /**
+     * Forward declaration of JavaArrayView, the class that gives a direct access
+     * to the elements of a primitive array.
+     */
+    template<typename T, bool Critical>
+    class JavaArrayView;
+
+    /**
+     * The JavaContext is a lightweight handle on the Java environment of the
+     * current thread.
+     * It is obtained once from the JavaVirtualMachineRegistry, and may then be
+     * passed to the methods of JavaMethod, JavaField and JavaArray so that they
+     * do not need to look up the environment on each call.
+     *
+     * A context must only be used by the thread that obtained it.
+     *
+     * @author Romain Wallon
+     *
+     * @version 0.1.0
+     */
+    class JavaContext {
+
+    public:
+
+        /**
+         * The ExceptionPolicy defines when a context checks whether an exception
+         * occurred in the Java Virtual Machine.
+         */
+        enum class ExceptionPolicy {
+
+            /**
+             * Exceptions are checked (and thrown) after each call.
+             */
+            IMMEDIATE,
+
+            /**
+             * Exceptions are only checked (and thrown) when checkException() is
+             * explicitly invoked.
+             * Note that no call should be performed while an exception is pending.
+             */
+            DEFERRED
+
+        };
+
+    private:
+
+        /**
+         * The native Java Environment provided by JNI.
+         */
+        JNIEnv *env;
+
+        /**
+         * The policy used to check exceptions after each call.
+         */
+        ExceptionPolicy policy;
+
+#ifndef NDEBUG
+        /**
+         * The number of critical regions entered by the current thread.
+         * It is only tracked in debug builds, to detect JNI calls performed
+         * while a CriticalView is held.
+         */
+        static inline thread_local int criticalRegions = 0;
+#endif
+
+    public:
+
+        /**
+         * Creates a new JavaContext.
+         *
+         * @param env The native Java Environment provided by JNI.
+         * @param policy The policy used to check exceptions after each call.
+         */
+        explicit JavaContext(JNIEnv *env, ExceptionPolicy policy = ExceptionPolicy::IMMEDIATE);
+
+        /**
+         * Gives the native Java Environment wrapped by this context.
+         *
+         * @return The native Java Environment.
+         */
+        [[nodiscard]] JNIEnv *getEnvironment() const {
+            assert(!isInCriticalRegion() && "No JNI call may be performed while a CriticalView is held");
+            return env;
+        }
+
+        /**
+         * Checks whether the current thread holds a CriticalView, in which case it
+         * must not perform any JNI call.
+         * This is only tracked in debug builds.
+         *
+         * @return Whether the current thread is in a critical region (always false
+         *         in release builds).
+         */
+        [[nodiscard]] static bool isInCriticalRegion() {
+#ifndef NDEBUG
+            return criticalRegions > 0;
+#else
+            return false;
+#endif
+        }
+
+        /**
+         * Gives the policy used by this context to check exceptions.
+         *
+         * @return The exception policy of this context.
+         */
+        [[nodiscard]] ExceptionPolicy getExceptionPolicy() const {
+            return policy;
+        }
+
+        /**
+         * Creates a copy of this context that uses another exception policy.
+         *
+         * @param newPolicy The exception policy to use.
+         *
+         * @return The new context.
+         */
+        [[nodiscard]] JavaContext withExceptionPolicy(ExceptionPolicy newPolicy) const {
+            return JavaContext(env, newPolicy);
+        }
+
+        /**
+         * Checks whether an exception occurred in the Java Virtual Machine after
+         * a call, provided that the policy of this context requires it.
+         *
+         * @throws JniException If an exception occurred and has to be checked.
+         */
+        void afterCall() const {
+            if (policy == ExceptionPolicy::IMMEDIATE) {
+                checkException();
+            }
+        }
+
+        /**
+         * Checks whether an exception occurred in the Java Virtual Machine,
+         * and throws it when this is the case.
+         *
+         * @throws JniException If an exception occurred.
+         */
+        void checkException() const;
+
+        /**
+         * The JavaArrayView is a friend class, which keeps track of the critical
+         * regions entered by the current thread.
+         */
+        template<typename T, bool Critical> friend class JavaArrayView;
+
+    };
+
+}
+
+#endif
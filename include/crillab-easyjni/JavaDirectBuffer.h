@@ -0,0 +1,437 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#ifndef EASYJNI_JAVADIRECTBUFFER_H
+#define EASYJNI_JAVADIRECTBUFFER_H
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <jni.h>
+
+#include "JavaObject.h"
+
+namespace easyjni {
+
+    /**
+     * The ByteOrder enumerates the byte orders that may be used by a direct
+     * buffer to read multi-byte values.
+     */
+    enum class ByteOrder {
+
+        /**
+         * Values are read in big-endian order (the default for Java buffers).
+         */
+        BIG,
+
+        /**
+         * Values are read in little-endian order.
+         */
+        LITTLE,
+
+        /**
+         * Values are read in the native order of the platform, i.e., in the order
+         * used by C++ to store them.
+         */
+        NATIVE
+
+    };
+
+    /**
+     * The JavaDirectBuffer exposes memory allocated in C++ to the Java Virtual
+     * Machine as a direct java.nio.ByteBuffer, so that Java code may read or
+     * write it without any copy.
+     *
+     * The ownership of the memory is explicit, and depends on how the buffer is
+     * created.
+     * A borrowed buffer only refers to memory owned by someone else, which must
+     * outlive both the buffer and every use of the ByteBuffer (or of any view of
+     * it) by Java code: JNI does not allow to invalidate a direct buffer, and
+     * accessing freed memory from Java crashes the Java Virtual Machine.
+     * An owning buffer, on the other hand, keeps its memory alive as long as Java
+     * code may reach the ByteBuffer: when the JavaDirectBuffer is destroyed, its
+     * memory is only released once the garbage collector has collected the direct
+     * buffer created by JNI.
+     * This buffer is tracked instead of the exposed one (which differs for
+     * read-only buffers), as every buffer derived from it (views, slices,
+     * duplicates or read-only copies, possibly derived in turn) keeps it reachable.
+     * This memory is reclaimed by reclaim(), which is also called whenever an
+     * owning buffer is created or destroyed.
+     * As the garbage collector may collect the Java buffers long after the last
+     * owning buffer has been destroyed, reclaim() should also be called
+     * periodically (e.g., after a garbage collection) by applications that hold
+     * large owned memory (such as mappings or pool arenas), and stop creating
+     * owning buffers.
+     *
+     * @author Romain Wallon
+     *
+     * @version 0.1.0
+     */
+    class JavaDirectBuffer {
+
+    public:
+
+        /**
+         * The maximum capacity of a buffer, as Java buffers are indexed by int values.
+         */
+        static constexpr std::size_t MAX_CAPACITY = 0x7fffffff;
+
+    private:
+
+        /**
+         * The (global reference to the) ByteBuffer in the Java Virtual Machine.
+         */
+        jobject buffer;
+
+        /**
+         * The weak reference to the direct buffer created by JNI, which remains
+         * reachable as long as a buffer derived from it is, or nullptr if the
+         * memory is borrowed.
+         */
+        jweak root;
+
+        /**
+         * The address of the memory exposed by the buffer.
+         */
+        void *address;
+
+        /**
+         * The capacity of the buffer, in bytes.
+         */
+        std::size_t capacity;
+
+        /**
+         * The memory owned by the buffer, or nullptr if the memory is borrowed.
+         */
+        std::shared_ptr<void> owner;
+
+    public:
+
+        /**
+         * Creates a buffer exposing memory owned by someone else, such as the content
+         * of a vector, or a block of an arena.
+         * The memory must outlive the buffer, and every use of the ByteBuffer by
+         * Java code.
+         *
+         * @tparam T The type of the values stored in the memory.
+         *
+         * @param memory The memory to expose.
+         * @param order The byte order of the buffer.
+         *
+         * @return The created buffer.
+         *
+         * @throws JniException If the buffer could not be created.
+         */
+        template<typename T>
+        requires (std::is_trivially_copyable_v<T> && !std::is_const_v<T>)
+        static JavaDirectBuffer borrow(std::span<T> memory, easyjni::ByteOrder order = easyjni::ByteOrder::NATIVE) {
+            return JavaDirectBuffer(static_cast<void *>(memory.data()), memory.size_bytes(), nullptr, order);
+        }
+
+        /**
+         * Creates a read-only buffer exposing constant memory owned by someone else.
+         * The memory must outlive the buffer, and every use of the ByteBuffer by
+         * Java code.
+         * As the memory is constant, it must not be written through data() or as().
+         *
+         * @tparam T The type of the values stored in the memory.
+         *
+         * @param memory The memory to expose.
+         * @param order The byte order of the buffer.
+         *
+         * @return The created buffer.
+         *
+         * @throws JniException If the buffer could not be created.
+         */
+        template<typename T>
+        requires std::is_trivially_copyable_v<T>
+        static JavaDirectBuffer borrow(std::span<const T> memory, easyjni::ByteOrder order = easyjni::ByteOrder::NATIVE) {
+            // Java code cannot write the memory, as it only sees a read-only buffer.
+            return JavaDirectBuffer(const_cast<T *>(memory.data()), memory.size_bytes(), nullptr, order, true);
+        }
+
+        /**
+         * Creates a buffer taking the ownership of the content of a vector.
+         * The content is released once the buffer has been destroyed, and the
+         * ByteBuffer has been collected.
+         *
+         * @tparam T The type of the values stored in the vector.
+         *
+         * @param memory The vector to adopt.
+         * @param order The byte order of the buffer.
+         *
+         * @return The created buffer.
+         *
+         * @throws JniException If the buffer could not be created.
+         */
+        template<typename T>
+        requires std::is_trivially_copyable_v<T>
+        static JavaDirectBuffer adopt(std::vector<T> &&memory, easyjni::ByteOrder order = easyjni::ByteOrder::NATIVE) {
+            auto owned = std::make_shared<std::vector<T>>(std::move(memory));
+            void *data = owned->data();
+            std::size_t size = owned->size() * sizeof(T);
+            return JavaDirectBuffer(data, size, std::move(owned), order);
+        }
+
+        /**
+         * Creates a buffer owning newly allocated (zero-initialized) memory.
+         * The memory is released once the buffer has been destroyed, and the
+         * ByteBuffer has been collected.
+         *
+         * @param capacity The capacity of the buffer, in bytes (at most MAX_CAPACITY).
+         * @param order The byte order of the buffer.
+         * @param alignment The alignment of the memory, which must be a power of two.
+         *
+         * @return The created buffer.
+         *
+         * @throws JniException If the buffer could not be created.
+         */
+        static JavaDirectBuffer allocate(std::size_t capacity, easyjni::ByteOrder order = easyjni::ByteOrder::NATIVE,
+                                         std::size_t alignment = 64);
+
+        /**
+         * Gives the memory exposed by a direct buffer created in the Java Virtual Machine.
+         * This memory is owned by the Java buffer, and must not be used once this
+         * buffer has been collected.
+         *
+         * @param buffer The direct buffer.
+         *
+         * @return The memory of the buffer.
+         *
+         * @throws JniException If the buffer is not a direct buffer.
+         */
+        static std::span<std::byte> getMemory(easyjni::JavaObject buffer);
+
+        /**
+         * Releases the memory of the destroyed owning buffers whose ByteBuffer has
+         * been collected by the garbage collector.
+         * Otherwise, this memory is only released when another owning buffer is
+         * created or destroyed.
+         *
+         * @return The number of buffers whose memory has been released.
+         */
+        static std::size_t reclaim();
+
+        /**
+         * Disables the copy of JavaDirectBuffer instances.
+         */
+        JavaDirectBuffer(const easyjni::JavaDirectBuffer &) = delete;
+
+        /**
+         * Disables the copy of JavaDirectBuffer instances.
+         */
+        easyjni::JavaDirectBuffer &operator=(const easyjni::JavaDirectBuffer &) = delete;
+
+        /**
+         * Creates a JavaDirectBuffer by moving another one.
+         *
+         * @param other The buffer to move, which does not refer to any memory anymore.
+         */
+        JavaDirectBuffer(easyjni::JavaDirectBuffer &&other) noexcept;
+
+        /**
+         * Moves a JavaDirectBuffer into this one, which releases its own buffer.
+         *
+         * @param other The buffer to move, which does not refer to any memory anymore.
+         *
+         * @return This buffer.
+         */
+        easyjni::JavaDirectBuffer &operator=(easyjni::JavaDirectBuffer &&other) noexcept;
+
+        /**
+         * Destroys this JavaDirectBuffer, releasing the reference to the Java buffer.
+         * The memory it owns (if any) is released once the Java buffer has been
+         * collected.
+         */
+        ~JavaDirectBuffer();
+
+        /**
+         * Gives the address of the memory exposed by this buffer.
+         *
+         * @return The address of the memory.
+         */
+        [[nodiscard]] void *data() const {
+            return address;
+        }
+
+        /**
+         * Gives the capacity of this buffer.
+         *
+         * @return The capacity of this buffer, in bytes.
+         */
+        [[nodiscard]] std::size_t size() const {
+            return capacity;
+        }
+
+        /**
+         * Checks whether this buffer owns the memory it exposes, i.e., whether this
+         * memory is kept alive as long as Java code may use it.
+         *
+         * @return Whether the memory is owned by this buffer.
+         */
+        [[nodiscard]] bool isOwning() const {
+            return owner != nullptr;
+        }
+
+        /**
+         * Gives a typed view of the memory exposed by this buffer.
+         *
+         * @tparam T The type of the values to view.
+         *
+         * @return The span of the values stored in the memory.
+         */
+        template<typename T>
+        requires std::is_trivially_copyable_v<T>
+        [[nodiscard]] std::span<T> as() const {
+            return std::span<T>(static_cast<T *>(address), capacity / sizeof(T));
+        }
+
+        /**
+         * Sets the byte order of this buffer, which is used by the typed views
+         * created afterwards.
+         *
+         * @param order The byte order to use.
+         *
+         * @throws JniException If the byte order could not be set.
+         */
+        void setByteOrder(easyjni::ByteOrder order);
+
+        /**
+         * Gives a view of this buffer as a java.nio.ShortBuffer.
+         * The view keeps the ByteBuffer reachable, and uses its current byte order.
+         *
+         * @return The created view, as a local reference.
+         *
+         * @throws JniException If the view could not be created.
+         */
+        easyjni::JavaObject asShortBuffer();
+
+        /**
+         * Gives a view of this buffer as a java.nio.IntBuffer.
+         * The view keeps the ByteBuffer reachable, and uses its current byte order.
+         *
+         * @return The created view, as a local reference.
+         *
+         * @throws JniException If the view could not be created.
+         */
+        easyjni::JavaObject asIntBuffer();
+
+        /**
+         * Gives a view of this buffer as a java.nio.LongBuffer.
+         * The view keeps the ByteBuffer reachable, and uses its current byte order.
+         *
+         * @return The created view, as a local reference.
+         *
+         * @throws JniException If the view could not be created.
+         */
+        easyjni::JavaObject asLongBuffer();
+
+        /**
+         * Gives a view of this buffer as a java.nio.FloatBuffer.
+         * The view keeps the ByteBuffer reachable, and uses its current byte order.
+         *
+         * @return The created view, as a local reference.
+         *
+         * @throws JniException If the view could not be created.
+         */
+        easyjni::JavaObject asFloatBuffer();
+
+        /**
+         * Gives a view of this buffer as a java.nio.DoubleBuffer.
+         * The view keeps the ByteBuffer reachable, and uses its current byte order.
+         *
+         * @return The created view, as a local reference.
+         *
+         * @throws JniException If the view could not be created.
+         */
+        easyjni::JavaObject asDoubleBuffer();
+
+        /**
+         * Gives the ByteBuffer in the Java Virtual Machine.
+         *
+         * @return The ByteBuffer, as an object wrapping the global reference owned
+         *         by this buffer (which must not be deleted).
+         */
+        easyjni::JavaObject toObject();
+
+        /**
+         * Gives the native pointer to the ByteBuffer in the Java Virtual Machine.
+         *
+         * @return The native (global) reference to the ByteBuffer.
+         */
+        jobject operator*() {
+            return buffer;
+        }
+
+    private:
+
+        /**
+         * Creates a new JavaDirectBuffer.
+         *
+         * @param address The address of the memory to expose.
+         * @param capacity The capacity of the buffer, in bytes.
+         * @param owner The memory owned by the buffer, or nullptr if the memory is borrowed.
+         * @param order The byte order of the buffer.
+         * @param readOnly Whether the Java buffer must be read-only.
+         *
+         * @throws JniException If the buffer could not be created.
+         */
+        JavaDirectBuffer(void *address, std::size_t capacity, std::shared_ptr<void> owner,
+                         easyjni::ByteOrder order, bool readOnly = false);
+
+        /**
+         * Releases the reference to the Java buffer, and hands the memory owned by
+         * this buffer (if any) over to reclaim().
+         */
+        void release();
+
+        /**
+         * Gives a typed view of this buffer.
+         *
+         * @param method The name of the method of ByteBuffer creating the view.
+         * @param type The internal name of the class of the view.
+         *
+         * @return The created view, as a local reference.
+         *
+         * @throws JniException If the view could not be created.
+         */
+        easyjni::JavaObject view(const char *method, const char *type);
+
+        /**
+         * The JavaDirectBufferPool is a friend class, which allows to create buffers
+         * sharing the ownership of the arenas they are carved from.
+         */
+        friend class JavaDirectBufferPool;
+
+        /**
+         * The JavaMappedFile is a friend class, which allows to create buffers
+         * owning (and possibly protecting) the files it maps.
+         */
+        friend class JavaMappedFile;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,496 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#ifndef EASYJNI_JAVADIRECTBUFFERPOOL_H
+#define EASYJNI_JAVADIRECTBUFFERPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <jni.h>
+
+#include "JavaDirectBuffer.h"
+#include "JavaMethod.h"
+#include "JavaObject.h"
+
+namespace easyjni {
+
+    /**
+     * Forward declaration of JavaPooledBuffer, the class representing the buffers
+     * lent by a JavaDirectBufferPool.
+     */
+    class JavaPooledBuffer;
+
+    /**
+     * The JavaDirectBufferPool lends reusable direct buffers, so that neither the
+     * memory nor the Java buffer objects are created for each request.
+     *
+     * Buffers are grouped into size classes (powers of two between a minimum slot
+     * size and the size of an arena).
+     * The slots of all size classes are carved, one after the other, out of large
+     * aligned arenas, which are allocated on demand as long as the total memory
+     * budget of the pool is not exceeded.
+     * When the current arena is too small for a new slot, the rest of this arena
+     * is split into smaller slots before a new arena is allocated, so that no
+     * memory is wasted.
+     * The Java buffer of a slot is created the first time the slot is used, and
+     * then reused (after being cleared and given back its byte order) each time
+     * the slot is lent again.
+     * The limit of a lent buffer is always the requested size.
+     *
+     * A pool may be used by several threads.
+     * The lent buffers share the ownership of the slots with the pool, so that the
+     * slots are only destroyed once the pool has been destroyed and all buffers
+     * have been given back.
+     * The Java buffers of the slots share the ownership of their arena: as for any
+     * owning JavaDirectBuffer, an arena is only released once the Java buffers
+     * carved from it have been collected.
+     *
+     * @author Romain Wallon
+     *
+     * @version 0.1.0
+     */
+    class JavaDirectBufferPool {
+
+    public:
+
+        /**
+         * The Statistics gives metrics about the use of a pool.
+         */
+        struct Statistics {
+
+            /**
+             * The number of buffers that have been lent.
+             */
+            std::uint64_t acquisitions;
+
+            /**
+             * The number of buffers that have been lent by reusing a slot.
+             */
+            std::uint64_t hits;
+
+            /**
+             * The number of requests that have been rejected because of the budget.
+             */
+            std::uint64_t rejections;
+
+            /**
+             * The number of bytes allocated for arenas.
+             */
+            std::size_t reservedBytes;
+
+            /**
+             * The number of bytes in the slots that are currently lent.
+             */
+            std::size_t usedBytes;
+
+            /**
+             * The maximum number of bytes that may be allocated for arenas.
+             */
+            std::size_t budget;
+
+            /**
+             * Gives the proportion of buffers that have been lent by reusing a slot.
+             *
+             * @return The hit rate of the pool, between 0 and 1.
+             */
+            [[nodiscard]] double hitRate() const {
+                return (acquisitions == 0) ? 0 : (static_cast<double>(hits) / static_cast<double>(acquisitions));
+            }
+
+            /**
+             * Gives the proportion of the allocated memory that is currently lent.
+             *
+             * @return The occupancy of the pool, between 0 and 1.
+             */
+            [[nodiscard]] double occupancy() const {
+                return (reservedBytes == 0) ? 0 : (static_cast<double>(usedBytes) / static_cast<double>(reservedBytes));
+            }
+
+        };
+
+    private:
+
+        /**
+         * The Slot is a region of an arena that is lent as a buffer.
+         */
+        struct Slot {
+
+            /**
+             * The direct buffer exposing the region.
+             */
+            easyjni::JavaDirectBuffer buffer;
+
+            /**
+             * The index of the size class of the slot.
+             */
+            std::size_t sizeClass;
+
+        };
+
+        /**
+         * The SizeClass stores the slots of a given size.
+         */
+        struct SizeClass {
+
+            /**
+             * The slots that are available.
+             */
+            std::vector<Slot *> available;
+
+        };
+
+        /**
+         * The Arena is a large block of memory from which slots are carved.
+         */
+        using Arena = std::shared_ptr<std::byte>;
+
+        /**
+         * The Shared holds the slots of a pool, which are shared with the buffers
+         * lent by this pool.
+         */
+        struct Shared {
+
+            /**
+             * The arena from which slots are currently carved.
+             */
+            Arena arena;
+
+            /**
+             * The next free byte of the current arena.
+             */
+            std::byte *next = nullptr;
+
+            /**
+             * The number of bytes remaining in the current arena.
+             */
+            std::size_t remaining = 0;
+
+            /**
+             * All the slots carved so far.
+             */
+            std::vector<std::unique_ptr<Slot>> slots;
+
+            /**
+             * The size classes of the pool.
+             */
+            std::vector<SizeClass> sizeClasses;
+
+            /**
+             * The metrics about the use of the pool.
+             */
+            Statistics statistics {};
+
+            /**
+             * The mutex used to avoid concurrent accesses to the slots.
+             */
+            std::mutex mutex;
+
+            /**
+             * Gives a slot back to the pool.
+             *
+             * @param slot The slot to give back.
+             */
+            void release(Slot *slot);
+
+        };
+
+        /**
+         * The size of the arenas, which is also the size of the largest slots.
+         */
+        std::size_t arenaSize;
+
+        /**
+         * The size of the smallest slots.
+         */
+        std::size_t minSlotSize;
+
+        /**
+         * The byte order of the buffers.
+         */
+        easyjni::ByteOrder order;
+
+        /**
+         * The (global reference to the) Java byte order of the buffers.
+         */
+        jobject byteOrder;
+
+        /**
+         * The method clearing a buffer before it is lent again.
+         */
+        easyjni::JavaMethod<easyjni::JavaObject> clearMethod;
+
+        /**
+         * The method restoring the byte order of a buffer before it is lent again.
+         */
+        easyjni::JavaMethod<easyjni::JavaObject> orderMethod;
+
+        /**
+         * The method setting the limit of a buffer to the requested size.
+         */
+        easyjni::JavaMethod<easyjni::JavaObject> limitMethod;
+
+        /**
+         * The slots of this pool.
+         */
+        std::shared_ptr<Shared> shared;
+
+    public:
+
+        /**
+         * Creates a new JavaDirectBufferPool.
+         * No memory is allocated until the first buffer is requested.
+         *
+         * @param budget The maximum number of bytes that may be allocated for arenas.
+         * @param arenaSize The size of each arena, which must be a power of two (at
+         *        most JavaDirectBuffer::MAX_CAPACITY).
+         * @param minSlotSize The size of the smallest slots, which must be a power of
+         *        two not greater than the size of an arena.
+         * @param order The byte order of the buffers.
+         *
+         * @throws JniException If the sizes are not valid.
+         */
+        explicit JavaDirectBufferPool(std::size_t budget, std::size_t arenaSize = 1 << 24,
+                                      std::size_t minSlotSize = 1 << 12,
+                                      easyjni::ByteOrder order = easyjni::ByteOrder::NATIVE);
+
+        /**
+         * Disables the copy of JavaDirectBufferPool instances.
+         */
+        JavaDirectBufferPool(const easyjni::JavaDirectBufferPool &) = delete;
+
+        /**
+         * Destroys this JavaDirectBufferPool.
+         * The buffers it has lent remain valid, and its slots are destroyed once
+         * all of them have been given back.
+         */
+        ~JavaDirectBufferPool();
+
+        /**
+         * Disables the copy of JavaDirectBufferPool instances.
+         */
+        easyjni::JavaDirectBufferPool &operator=(const easyjni::JavaDirectBufferPool &) = delete;
+
+        /**
+         * Lends a buffer of at least the given size.
+         * The position of the buffer is 0, and its limit is the requested size.
+         *
+         * @param size The number of bytes needed.
+         *
+         * @return The lent buffer.
+         *
+         * @throws JniException If the size is larger than an arena, if lending the
+         *         buffer would exceed the budget of this pool, or if the Java buffer
+         *         could not be created.
+         */
+        easyjni::JavaPooledBuffer acquire(std::size_t size);
+
+        /**
+         * Gives the metrics about the use of this pool.
+         *
+         * @return A snapshot of the metrics.
+         */
+        [[nodiscard]] Statistics getStatistics() const;
+
+    private:
+
+        /**
+         * Takes a slot of the given size class, carving it from an arena if needed.
+         * This method must be called while holding the mutex of the slots.
+         *
+         * @param index The index of the size class.
+         *
+         * @return The slot.
+         *
+         * @throws JniException If the budget of this pool would be exceeded.
+         */
+        Slot *take(std::size_t index);
+
+        /**
+         * Carves a new slot of the given size class out of the current arena.
+         * This method must be called while holding the mutex of the slots.
+         *
+         * @param index The index of the size class.
+         *
+         * @return The carved slot.
+         *
+         * @throws JniException If the Java buffer of the slot could not be created.
+         */
+        Slot *carve(std::size_t index);
+
+        /**
+         * The JavaPooledBuffer is a friend class, which shares the slots of the pool
+         * and gives its slot back when destroyed.
+         */
+        friend class JavaPooledBuffer;
+
+    };
+
+    /**
+     * The JavaPooledBuffer is a direct buffer lent by a JavaDirectBufferPool.
+     * It is given back to the pool when destroyed, and shares the ownership of
+     * the slots of this pool, which may thus be destroyed first.
+     * Java code must not use the buffer once it has been given back, as it may
+     * then be lent to someone else.
+     *
+     * @author Romain Wallon
+     *
+     * @version 0.1.0
+     */
+    class JavaPooledBuffer {
+
+    private:
+
+        /**
+         * The slots of the pool from which the buffer has been lent, or nullptr if
+         * this buffer has been moved.
+         */
+        std::shared_ptr<easyjni::JavaDirectBufferPool::Shared> pool;
+
+        /**
+         * The slot of the pool holding the buffer.
+         */
+        easyjni::JavaDirectBufferPool::Slot *slot;
+
+        /**
+         * The number of bytes that have been requested.
+         */
+        std::size_t length;
+
+    public:
+
+        /**
+         * Disables the copy of JavaPooledBuffer instances.
+         */
+        JavaPooledBuffer(const easyjni::JavaPooledBuffer &) = delete;
+
+        /**
+         * Disables the copy of JavaPooledBuffer instances.
+         */
+        easyjni::JavaPooledBuffer &operator=(const easyjni::JavaPooledBuffer &) = delete;
+
+        /**
+         * Creates a JavaPooledBuffer by moving another one.
+         *
+         * @param other The buffer to move, which does not hold any buffer anymore.
+         */
+        JavaPooledBuffer(easyjni::JavaPooledBuffer &&other) noexcept;
+
+        /**
+         * Moves a JavaPooledBuffer into this one, which gives its own buffer back.
+         *
+         * @param other The buffer to move, which does not hold any buffer anymore.
+         *
+         * @return This buffer.
+         */
+        easyjni::JavaPooledBuffer &operator=(easyjni::JavaPooledBuffer &&other) noexcept;
+
+        /**
+         * Destroys this JavaPooledBuffer, giving its buffer back to the pool.
+         */
+        ~JavaPooledBuffer();
+
+        /**
+         * Gives the address of the memory of this buffer.
+         *
+         * @return The address of the memory.
+         */
+        [[nodiscard]] void *data() const {
+            return slot->buffer.data();
+        }
+
+        /**
+         * Gives the number of bytes that have been requested for this buffer.
+         *
+         * @return The requested size, in bytes.
+         */
+        [[nodiscard]] std::size_t size() const {
+            return length;
+        }
+
+        /**
+         * Gives the capacity of this buffer, i.e., the size of its class in the pool,
+         * which may be larger than the requested size.
+         *
+         * @return The capacity, in bytes.
+         */
+        [[nodiscard]] std::size_t capacity() const {
+            return slot->buffer.size();
+        }
+
+        /**
+         * Gives a typed view of the requested memory of this buffer.
+         *
+         * @tparam T The type of the values to view.
+         *
+         * @return The span of the values stored in the memory.
+         */
+        template<typename T>
+        requires std::is_trivially_copyable_v<T>
+        [[nodiscard]] std::span<T> as() const {
+            return std::span<T>(static_cast<T *>(slot->buffer.data()), length / sizeof(T));
+        }
+
+        /**
+         * Gives the ByteBuffer in the Java Virtual Machine.
+         *
+         * @return The ByteBuffer, as an object.
+         */
+        easyjni::JavaObject toObject() {
+            return slot->buffer.toObject();
+        }
+
+        /**
+         * Gives the native pointer to the ByteBuffer in the Java Virtual Machine.
+         *
+         * @return The native (global) reference to the ByteBuffer.
+         */
+        jobject operator*() {
+            return *slot->buffer;
+        }
+
+    private:
+
+        /**
+         * Creates a new JavaPooledBuffer.
+         *
+         * @param pool The slots of the pool from which the buffer is lent.
+         * @param slot The slot of the pool holding the buffer.
+         * @param length The number of bytes that have been requested.
+         */
+        JavaPooledBuffer(std::shared_ptr<easyjni::JavaDirectBufferPool::Shared> pool,
+                         easyjni::JavaDirectBufferPool::Slot *slot, std::size_t length);
+
+        /**
+         * The JavaDirectBufferPool is a friend class, which allows to lend
+         * its buffers.
+         */
+        friend class JavaDirectBufferPool;
+
+    };
+
+}
+
+#endif
@@ -40,9 +40,10 @@ namespace easyjni {
     protected:
 
         /**
-         * The name of this element.
+         * The name of this element, interned so that elements remain trivially
+         * copyable, and can be passed by value without copying their name.
          */
-        std::string name;
+        const std::string *name;
 
     protected:
 
@@ -66,6 +67,19 @@ namespace easyjni {
          */
         static void checkException();
 
+    private:
+
+        /**
+         * Interns the given name, so that all elements with the same name share
+         * the same string.
+         * Interned names are never released.
+         *
+         * @param name The name to intern.
+         *
+         * @return The interned name.
+         */
+        static const std::string *intern(std::string name);
+
     public:
 
         /**
@@ -0,0 +1,226 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#ifndef EASYJNI_JAVAEXECUTOR_H
+#define EASYJNI_JAVAEXECUTOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "JavaContext.h"
+
+namespace easyjni {
+
+    /**
+     * The JavaExecutor is a pool of threads that are attached to the Java Virtual
+     * Machine once, when the executor is created, and detached when it is destroyed.
+     * Tasks submitted to the executor may thus perform Java calls without paying
+     * the cost of attaching their thread.
+     *
+     * Each worker owns a queue of tasks, and idle workers steal tasks from the
+     * queues of the other workers.
+     *
+     * @author Romain Wallon
+     *
+     * @version 0.1.0
+     */
+    class JavaExecutor {
+
+    private:
+
+        /**
+         * The Worker stores the queue of the tasks assigned to a thread of the executor.
+         */
+        struct Worker {
+
+            /**
+             * The tasks assigned to the worker.
+             * The worker takes its tasks from the back, while other workers steal from the front.
+             */
+            std::deque<std::function<void(const easyjni::JavaContext &)>> tasks;
+
+            /**
+             * The mutex used to avoid concurrent accesses to the tasks.
+             */
+            std::mutex mutex;
+
+        };
+
+        /**
+         * The workers of this executor.
+         */
+        std::vector<std::unique_ptr<Worker>> workers;
+
+        /**
+         * The threads running the workers.
+         */
+        std::vector<std::thread> threads;
+
+        /**
+         * The number of tasks that have been submitted but not started yet.
+         */
+        std::atomic<std::size_t> pending;
+
+        /**
+         * The index of the next worker to which a task submitted from outside the
+         * executor is assigned.
+         */
+        std::atomic<std::size_t> nextWorker;
+
+        /**
+         * Whether this executor is being shut down.
+         */
+        bool stopping;
+
+        /**
+         * The mutex used to put idle workers to sleep.
+         */
+        std::mutex mutex;
+
+        /**
+         * The condition used to wake up idle workers.
+         */
+        std::condition_variable condition;
+
+    public:
+
+        /**
+         * Creates a new JavaExecutor, and attaches all its threads to the Java
+         * Virtual Machine before returning.
+         *
+         * @param nbThreads The number of threads of the executor.
+         *
+         * @throws JniException If no Java Virtual Machine has been registered yet.
+         */
+        explicit JavaExecutor(unsigned int nbThreads = std::thread::hardware_concurrency());
+
+        /**
+         * Forbids the copy of an executor.
+         */
+        JavaExecutor(const easyjni::JavaExecutor &) = delete;
+
+        /**
+         * Forbids the copy of an executor.
+         */
+        easyjni::JavaExecutor &operator=(const easyjni::JavaExecutor &) = delete;
+
+        /**
+         * Destroys this executor.
+         * The tasks that have already been submitted are executed before the
+         * threads are detached from the Java Virtual Machine and joined.
+         */
+        ~JavaExecutor();
+
+        /**
+         * Gives the number of threads of this executor.
+         *
+         * @return The number of threads.
+         */
+        [[nodiscard]] std::size_t size() const {
+            return threads.size();
+        }
+
+        /**
+         * Checks whether the current thread is one of the workers of this executor.
+         * A worker must not block on the tasks it submits to its own executor, as
+         * these tasks may be queued behind it.
+         *
+         * @return Whether the current thread is a worker of this executor.
+         */
+        [[nodiscard]] bool isWorkerThread() const;
+
+        /**
+         * Submits a task to this executor.
+         * The task may either take no parameter, or the JavaContext of the worker
+         * thread executing it.
+         *
+         * @tparam F The type of the task.
+         *
+         * @param task The task to execute.
+         *
+         * @return The future value computed by the task.
+         */
+        template<typename F>
+        auto submit(F &&task) {
+            if constexpr (std::is_invocable_v<F, const easyjni::JavaContext &>) {
+                using R = std::invoke_result_t<F, const easyjni::JavaContext &>;
+                auto packaged = std::make_shared<std::packaged_task<R(const easyjni::JavaContext &)>>(
+                        std::forward<F>(task));
+                auto future = packaged->get_future();
+                schedule([packaged](const easyjni::JavaContext &context) { (*packaged)(context); });
+                return future;
+
+            } else {
+                using R = std::invoke_result_t<F>;
+                auto packaged = std::make_shared<std::packaged_task<R()>>(std::forward<F>(task));
+                auto future = packaged->get_future();
+                schedule([packaged](const easyjni::JavaContext &) { (*packaged)(); });
+                return future;
+            }
+        }
+
+    private:
+
+        /**
+         * Shuts down this executor, by waiting for all its threads to terminate.
+         */
+        void shutdown();
+
+        /**
+         * Assigns a task to one of the workers of this executor.
+         * If the current thread is a worker of this executor, the task is assigned
+         * to this worker.
+         *
+         * @param task The task to assign.
+         */
+        void schedule(std::function<void(const easyjni::JavaContext &)> task);
+
+        /**
+         * Runs the worker at the given index until this executor is shut down.
+         *
+         * @param index The index of the worker to run.
+         * @param ready The promise to fulfill once the thread is attached.
+         */
+        void run(std::size_t index, std::promise<void> &ready);
+
+        /**
+         * Takes the next task to execute by a worker, from its own queue or by
+         * stealing it from another worker.
+         *
+         * @param index The index of the worker looking for a task.
+         * @param task The reference where to store the task, if any.
+         *
+         * @return Whether a task has been found.
+         */
+        bool take(std::size_t index, std::function<void(const easyjni::JavaContext &)> &task);
+
+    };
+
+}
+
+#endif
@@ -21,12 +21,14 @@
 #ifndef EASYJNI_JAVAFIELD_H
 #define EASYJNI_JAVAFIELD_H
 
-#include <functional>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 #include <jni.h>
 
 #include "JavaClass.h"
+#include "JavaContext.h"
 #include "JavaElement.h"
 #include "JavaObject.h"
 #include "JniException.h"
@@ -54,26 +56,6 @@ namespace easyjni {
          */
         jfieldID nativeField;
 
-        /**
-         * The function to use to get the value of this (instance) field for a particular object.
-         */
-        std::function<T(JNIEnv *, jobject, jfieldID)> getter;
-
-        /**
-         * The function to use to set the value of this (instance) field for a particular object.
-         */
-        std::function<void(JNIEnv *, jobject, jfieldID, T)> setter;
-
-        /**
-         * The function to use to get the value of this (static) field in the class.
-         */
-        std::function<T(JNIEnv *, jclass, jfieldID)> staticGetter;
-
-        /**
-         * The function to use to set the value of this (static) field in the class.
-         */
-        std::function<void(JNIEnv *, jclass, jfieldID, T)> staticSetter;
-
     private:
 
         /**
@@ -81,22 +63,10 @@ namespace easyjni {
          *
          * @param name The name of the field.
          * @param nativeField The native pointer to the field in the Java Virtual Machine.
-         * @param getter The function to use to get the value of the (instance) field for a particular object.
-         * @param setter The function to use to set the value of the (instance) field for a particular object.
-         * @param staticGetter The function to use to get the value of the (static) field in the class.
-         * @param staticSetter The function to use to set the value of the (static) field in the class.
-         */
-        explicit JavaField(std::string name, jfieldID nativeField,
-                  std::function<T(JNIEnv *, jobject, jfieldID)> getter,
-                  std::function<void(JNIEnv *, jobject, jfieldID, T)> setter,
-                  std::function<T(JNIEnv *, jclass, jfieldID)> staticGetter,
-                  std::function<void(JNIEnv *, jclass, jfieldID, T)> staticSetter) :
+         */
+        explicit JavaField(std::string name, jfieldID nativeField) :
                 JavaElement(std::move(name)),
-                nativeField(nativeField),
-                getter(getter),
-                setter(setter),
-                staticGetter(staticGetter),
-                staticSetter(staticSetter) {
+                nativeField(nativeField) {
             // Nothing to do: everything is already initialized.
         }
 
@@ -108,7 +78,9 @@ namespace easyjni {
          *
          * @return The created JavaField.
          */
-        static JavaField<T> newInstance(std::string name, jfieldID nativeField);
+        static JavaField<T> newInstance(std::string name, jfieldID nativeField) {
+            return JavaField<T>(std::move(name), nativeField);
+        }
 
     public:
 
@@ -122,11 +94,29 @@ namespace easyjni {
          * @throws JniException If an error occurred while getting the field.
          */
         T get(easyjni::JavaObject &object) {
-            T value = getter(getEnvironment(), *object, nativeField);
+            T value = read(getEnvironment(), *object);
             checkException();
             return value;
         }
 
+        /**
+         * Gets the value of this (instance) field for the given object, using the
+         * given context.
+         *
+         * @param context The context of the current thread.
+         * @param object The object for which to get the value of this field.
+         *
+         * @return The value of this field for the given object.
+         *
+         * @throws JniException If an error occurred while getting the field, and
+         *         the context checks exceptions immediately.
+         */
+        T get(const easyjni::JavaContext &context, easyjni::JavaObject &object) {
+            T value = read(context.getEnvironment(), *object);
+            context.afterCall();
+            return value;
+        }
+
         /**
          * Sets the value of this (instance) field for the given object.
          *
@@ -136,10 +126,26 @@ namespace easyjni {
          * @throws JniException If an error occurred while setting the field.
          */
         void set(easyjni::JavaObject &object, T value) {
-            setter(getEnvironment(), *object, nativeField, value);
+            write(getEnvironment(), *object, value);
             checkException();
         }
 
+        /**
+         * Sets the value of this (instance) field for the given object, using the
+         * given context.
+         *
+         * @param context The context of the current thread.
+         * @param object The object for which to set the value of this field.
+         * @param value The new value for this field.
+         *
+         * @throws JniException If an error occurred while setting the field, and
+         *         the context checks exceptions immediately.
+         */
+        void set(const easyjni::JavaContext &context, easyjni::JavaObject &object, T value) {
+            write(context.getEnvironment(), *object, value);
+            context.afterCall();
+        }
+
         /**
          * Gets the value of this (static) field for the given class.
          *
@@ -150,11 +156,29 @@ namespace easyjni {
          * @throws JniException If an error occurred while getting the field.
          */
         T getStatic(easyjni::JavaClass &clazz) {
-            T value = staticGetter(getEnvironment(), *clazz, nativeField);
+            T value = readStatic(getEnvironment(), *clazz);
             checkException();
             return value;
         }
 
+        /**
+         * Gets the value of this (static) field for the given class, using the
+         * given context.
+         *
+         * @param context The context of the current thread.
+         * @param clazz The class for which to get the value of this field.
+         *
+         * @return The value of this field for the given class.
+         *
+         * @throws JniException If an error occurred while getting the field, and
+         *         the context checks exceptions immediately.
+         */
+        T getStatic(const easyjni::JavaContext &context, easyjni::JavaClass &clazz) {
+            T value = readStatic(context.getEnvironment(), *clazz);
+            context.afterCall();
+            return value;
+        }
+
         /**
          * Sets the value of this (static) field for the given class.
          *
@@ -164,10 +188,182 @@ namespace easyjni {
          * @throws JniException If an error occurred while setting the field.
          */
         void setStatic(easyjni::JavaClass &clazz, T value) {
-            staticSetter(getEnvironment(), *clazz, value);
+            writeStatic(getEnvironment(), *clazz, value);
             checkException();
         }
 
+        /**
+         * Sets the value of this (static) field for the given class, using the
+         * given context.
+         *
+         * @param context The context of the current thread.
+         * @param clazz The class for which to set the value of this field.
+         * @param value The new value for this field.
+         *
+         * @throws JniException If an error occurred while setting the field, and
+         *         the context checks exceptions immediately.
+         */
+        void setStatic(const easyjni::JavaContext &context, easyjni::JavaClass &clazz, T value) {
+            writeStatic(context.getEnvironment(), *clazz, value);
+            context.afterCall();
+        }
+
+    private:
+
+        /**
+         * Reads the value of this (instance) field for a particular object.
+         *
+         * @param env The native Java Environment provided by JNI.
+         * @param object The object for which to read the value of this field.
+         *
+         * @return The value of this field for the object.
+         */
+        T read(JNIEnv *env, jobject object) {
+            if constexpr (std::is_same_v<T, jboolean>) {
+                return env->GetBooleanField(object, nativeField);
+
+            } else if constexpr (std::is_same_v<T, jbyte>) {
+                return env->GetByteField(object, nativeField);
+
+            } else if constexpr (std::is_same_v<T, jchar>) {
+                return env->GetCharField(object, nativeField);
+
+            } else if constexpr (std::is_same_v<T, jshort>) {
+                return env->GetShortField(object, nativeField);
+
+            } else if constexpr (std::is_same_v<T, jint>) {
+                return env->GetIntField(object, nativeField);
+
+            } else if constexpr (std::is_same_v<T, jlong>) {
+                return env->GetLongField(object, nativeField);
+
+            } else if constexpr (std::is_same_v<T, jfloat>) {
+                return env->GetFloatField(object, nativeField);
+
+            } else if constexpr (std::is_same_v<T, jdouble>) {
+                return env->GetDoubleField(object, nativeField);
+
+            } else {
+                static_assert(std::is_same_v<T, easyjni::JavaObject>, "Unsupported field type");
+                return easyjni::JavaObject(env->GetObjectField(object, nativeField));
+            }
+        }
+
+        /**
+         * Writes the value of this (instance) field for a particular object.
+         *
+         * @param env The native Java Environment provided by JNI.
+         * @param object The object for which to write the value of this field.
+         * @param value The new value for this field.
+         */
+        void write(JNIEnv *env, jobject object, T value) {
+            if constexpr (std::is_same_v<T, jboolean>) {
+                env->SetBooleanField(object, nativeField, value);
+
+            } else if constexpr (std::is_same_v<T, jbyte>) {
+                env->SetByteField(object, nativeField, value);
+
+            } else if constexpr (std::is_same_v<T, jchar>) {
+                env->SetCharField(object, nativeField, value);
+
+            } else if constexpr (std::is_same_v<T, jshort>) {
+                env->SetShortField(object, nativeField, value);
+
+            } else if constexpr (std::is_same_v<T, jint>) {
+                env->SetIntField(object, nativeField, value);
+
+            } else if constexpr (std::is_same_v<T, jlong>) {
+                env->SetLongField(object, nativeField, value);
+
+            } else if constexpr (std::is_same_v<T, jfloat>) {
+                env->SetFloatField(object, nativeField, value);
+
+            } else if constexpr (std::is_same_v<T, jdouble>) {
+                env->SetDoubleField(object, nativeField, value);
+
+            } else {
+                static_assert(std::is_same_v<T, easyjni::JavaObject>, "Unsupported field type");
+                env->SetObjectField(object, nativeField, *value);
+            }
+        }
+
+        /**
+         * Reads the value of this (static) field in a class.
+         *
+         * @param env The native Java Environment provided by JNI.
+         * @param clazz The class for which to read the value of this field.
+         *
+         * @return The value of this field for the class.
+         */
+        T readStatic(JNIEnv *env, jclass clazz) {
+            if constexpr (std::is_same_v<T, jboolean>) {
+                return env->GetStaticBooleanField(clazz, nativeField);
+
+            } else if constexpr (std::is_same_v<T, jbyte>) {
+                return env->GetStaticByteField(clazz, nativeField);
+
+            } else if constexpr (std::is_same_v<T, jchar>) {
+                return env->GetStaticCharField(clazz, nativeField);
+
+            } else if constexpr (std::is_same_v<T, jshort>) {
+                return env->GetStaticShortField(clazz, nativeField);
+
+            } else if constexpr (std::is_same_v<T, jint>) {
+                return env->GetStaticIntField(clazz, nativeField);
+
+            } else if constexpr (std::is_same_v<T, jlong>) {
+                return env->GetStaticLongField(clazz, nativeField);
+
+            } else if constexpr (std::is_same_v<T, jfloat>) {
+                return env->GetStaticFloatField(clazz, nativeField);
+
+            } else if constexpr (std::is_same_v<T, jdouble>) {
+                return env->GetStaticDoubleField(clazz, nativeField);
+
+            } else {
+                static_assert(std::is_same_v<T, easyjni::JavaObject>, "Unsupported field type");
+                return easyjni::JavaObject(env->GetStaticObjectField(clazz, nativeField));
+            }
+        }
+
+        /**
+         * Writes the value of this (static) field in a class.
+         *
+         * @param env The native Java Environment provided by JNI.
+         * @param clazz The class for which to write the value of this field.
+         * @param value The new value for this field.
+         */
+        void writeStatic(JNIEnv *env, jclass clazz, T value) {
+            if constexpr (std::is_same_v<T, jboolean>) {
+                env->SetStaticBooleanField(clazz, nativeField, value);
+
+            } else if constexpr (std::is_same_v<T, jbyte>) {
+                env->SetStaticByteField(clazz, nativeField, value);
+
+            } else if constexpr (std::is_same_v<T, jchar>) {
+                env->SetStaticCharField(clazz, nativeField, value);
+
+            } else if constexpr (std::is_same_v<T, jshort>) {
+                env->SetStaticShortField(clazz, nativeField, value);
+
+            } else if constexpr (std::is_same_v<T, jint>) {
+                env->SetStaticIntField(clazz, nativeField, value);
+
+            } else if constexpr (std::is_same_v<T, jlong>) {
+                env->SetStaticLongField(clazz, nativeField, value);
+
+            } else if constexpr (std::is_same_v<T, jfloat>) {
+                env->SetStaticFloatField(clazz, nativeField, value);
+
+            } else if constexpr (std::is_same_v<T, jdouble>) {
+                env->SetStaticDoubleField(clazz, nativeField, value);
+
+            } else {
+                static_assert(std::is_same_v<T, easyjni::JavaObject>, "Unsupported field type");
+                env->SetStaticObjectField(clazz, nativeField, *value);
+            }
+        }
+
         /**
          * The JavaClass is a friend class, which uses JavaField to represent
          * the fields it declares.
@@ -176,6 +372,8 @@ namespace easyjni {
 
     };
 
+    static_assert(std::is_trivially_copyable_v<easyjni::JavaField<jint>>, "Java field handles must be trivially copyable");
+
 }
 
 #endif
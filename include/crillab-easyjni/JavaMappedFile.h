@@ -0,0 +1,112 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#ifndef EASYJNI_JAVAMAPPEDFILE_H
+#define EASYJNI_JAVAMAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+#include "JavaDirectBuffer.h"
+
+namespace easyjni {
+
+    /**
+     * The MapMode enumerates the modes in which a file may be mapped.
+     */
+    enum class MapMode {
+
+        /**
+         * The file is mapped for reading only, and the Java buffer is read-only.
+         */
+        READ_ONLY,
+
+        /**
+         * The file is mapped for reading and writing, and changes made either from
+         * C++ or from Java are written back to the file.
+         */
+        READ_WRITE
+
+    };
+
+    /**
+     * The JavaMappedFile maps (a window of) a file into memory, and exposes the
+     * mapping to the Java Virtual Machine as a direct ByteBuffer.
+     * The file is thus shared between C++ and Java through a single mapping,
+     * instead of being read by both sides into their own memory.
+     *
+     * The mapping is owned by the returned JavaDirectBuffer: as for any owning
+     * buffer, it is only unmapped once this buffer has been destroyed and the
+     * direct buffer created by JNI has been collected, which happens only after
+     * every buffer derived from it (including the slices of a read-only mapping)
+     * has been collected too, so that Java code never accesses unmapped memory.
+     * Mapping files is only supported on POSIX systems.
+     *
+     * @author Romain Wallon
+     *
+     * @version 0.1.0
+     */
+    class JavaMappedFile {
+
+    public:
+
+        /**
+         * Disables instantiation.
+         */
+        JavaMappedFile() = delete;
+
+        /**
+         * Maps a window of a file into memory, and exposes it as a direct buffer.
+         *
+         * @param path The path of the file to map.
+         * @param mode The mode in which to map the file.
+         * @param offset The offset (in bytes) of the window in the file, which does
+         *        not need to be aligned on a page.
+         * @param length The length (in bytes) of the window, or 0 to map the file
+         *        up to its end.
+         * @param hugePages Whether to advise the system to back the mapping with huge
+         *        pages (this is only a best-effort hint: it is ignored when the system
+         *        does not support it or refuses it, and never makes the mapping fail).
+         * @param order The byte order of the buffer.
+         *
+         * @return The buffer owning the mapping.
+         *
+         * @throws JniException If the file could not be mapped, or if the window is
+         *         empty, out of the bounds of the file, or larger than a Java buffer.
+         */
+        static easyjni::JavaDirectBuffer map(const std::string &path, easyjni::MapMode mode = easyjni::MapMode::READ_ONLY,
+                                             std::size_t offset = 0, std::size_t length = 0, bool hugePages = false,
+                                             easyjni::ByteOrder order = easyjni::ByteOrder::NATIVE);
+
+        /**
+         * Writes the changes made to a mapped file back to the storage device,
+         * as MappedByteBuffer.force() does in Java.
+         *
+         * @param buffer The buffer owning the mapping.
+         *
+         * @throws JniException If the changes could not be written.
+         */
+        static void sync(const easyjni::JavaDirectBuffer &buffer);
+
+    };
+
+}
+
+#endif
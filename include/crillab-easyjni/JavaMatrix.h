@@ -0,0 +1,378 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#ifndef EASYJNI_JAVAMATRIX_H
+#define EASYJNI_JAVAMATRIX_H
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <jni.h>
+
+#include "JavaArray.h"
+#include "JavaContext.h"
+#include "JavaObject.h"
+#include "JavaSignature.h"
+#include "JavaVirtualMachine.h"
+#include "JavaVirtualMachineRegistry.h"
+#include "JniException.h"
+
+namespace easyjni {
+
+    /**
+     * The JavaMatrix represents a two-dimensional array of primitive values in
+     * the Java Virtual Machine (e.g., a double[][]), which may be either
+     * rectangular or jagged.
+     * Its elements are transferred from and to contiguous C++ buffers in which
+     * the rows are stored one after the other (in row-major order), with a single
+     * JNI region copy per row.
+     * The local reference to each row is released as soon as the row has been
+     * copied, so that transfers do not depend on the local reference capacity.
+     *
+     * @tparam T The type of the elements in the matrix.
+     *
+     * @author Romain Wallon
+     *
+     * @version 0.1.0
+     */
+    template<typename T>
+    requires (!std::is_same_v<T, easyjni::JavaObject>)
+    class JavaMatrix {
+
+    private:
+
+        /**
+         * The native pointer to the array of rows in the Java Virtual Machine.
+         */
+        jobjectArray rows;
+
+    public:
+
+        /**
+         * Creates a new JavaMatrix.
+         *
+         * @param rows The array of rows of the matrix.
+         */
+        explicit JavaMatrix(easyjni::JavaArray<easyjni::JavaObject> rows) :
+                rows((jobjectArray) *rows) {
+            // Nothing to do: everything is already initialized.
+        }
+
+        /**
+         * Creates a rectangular matrix in the Java Virtual Machine, containing the
+         * given elements.
+         *
+         * @param elements The elements of the matrix, in row-major order.
+         * @param nbColumns The number of columns of the matrix.
+         *
+         * @return The created matrix.
+         *
+         * @throws JniException If the number of elements is not a multiple of the
+         *         number of columns, or if an error occurred while creating the matrix.
+         */
+        static JavaMatrix<T> create(std::span<const T> elements, int nbColumns) {
+            if ((nbColumns <= 0) || ((elements.size() % nbColumns) != 0)) {
+                throw JniException("Cannot create a matrix with " + std::to_string(nbColumns)
+                                   + " columns from " + std::to_string(elements.size()) + " elements");
+            }
+
+            auto jvm = JavaVirtualMachineRegistry::get();
+            auto nbRows = static_cast<int>(elements.size() / nbColumns);
+            auto rowClass = jvm->loadClass(JavaTypeDescriptor<easyjni::JavaArray<T>>::value.c_str());
+            JavaMatrix<T> matrix(jvm->createObjectArray(nbRows, rowClass));
+
+            auto context = JavaVirtualMachineRegistry::getContext();
+            auto env = context.getEnvironment();
+            for (int i = 0; i < nbRows; i++) {
+                jarray row = newRow(env, nbColumns);
+                if (row == nullptr) {
+                    context.checkException();
+                    throw JniException("Could not create row #" + std::to_string(i) + " of a matrix");
+                }
+                easyjni::JavaArray<T>(row).setRegion(context, 0, elements.subspan(i * nbColumns, nbColumns));
+                env->SetObjectArrayElement(matrix.rows, i, row);
+                env->DeleteLocalRef(row);
+                context.checkException();
+            }
+            return matrix;
+        }
+
+        /**
+         * Gives the number of rows of this matrix.
+         *
+         * @return The number of rows.
+         */
+        int getNbRows() {
+            return getNbRows(JavaVirtualMachineRegistry::getContext());
+        }
+
+        /**
+         * Gives the number of rows of this matrix, using the given context.
+         *
+         * @param context The context of the current thread.
+         *
+         * @return The number of rows.
+         */
+        int getNbRows(const easyjni::JavaContext &context) {
+            auto nbRows = context.getEnvironment()->GetArrayLength(rows);
+            context.afterCall();
+            return nbRows;
+        }
+
+        /**
+         * Gives the length of each row of this matrix.
+         *
+         * @return The lengths of the rows.
+         *
+         * @throws JniException If a row is null, or could not be read.
+         */
+        std::vector<int> getRowLengths() {
+            return getRowLengths(JavaVirtualMachineRegistry::getContext());
+        }
+
+        /**
+         * Gives the length of each row of this matrix, using the given context.
+         *
+         * @param context The context of the current thread.
+         *
+         * @return The lengths of the rows.
+         *
+         * @throws JniException If a row is null, or could not be read and the context
+         *         checks exceptions immediately.
+         */
+        std::vector<int> getRowLengths(const easyjni::JavaContext &context) {
+            std::vector<int> lengths;
+            forEachRow(context, [&](jarray, int length) {
+                lengths.push_back(length);
+                return true;
+            });
+            return lengths;
+        }
+
+        /**
+         * Copies all the elements of this matrix into the given buffer, row after row.
+         *
+         * @param elements The buffer in which to copy the elements.
+         *
+         * @return The number of copied elements.
+         *
+         * @throws JniException If the buffer is too small, if a row is null, or if
+         *         an error occurred while copying the elements.
+         */
+        std::size_t copyTo(std::span<T> elements) {
+            return copyTo(JavaVirtualMachineRegistry::getContext(), elements);
+        }
+
+        /**
+         * Copies all the elements of this matrix into the given buffer, row after row,
+         * using the given context.
+         *
+         * @param context The context of the current thread.
+         * @param elements The buffer in which to copy the elements.
+         *
+         * @return The number of copied elements.
+         *
+         * @throws JniException If the buffer is too small, if a row is null, or if
+         *         an error occurred while copying the elements and the context checks
+         *         exceptions immediately.
+         */
+        std::size_t copyTo(const easyjni::JavaContext &context, std::span<T> elements) {
+            std::size_t offset = 0;
+            forEachRow(context, [&](jarray row, int length) {
+                if (offset + length > elements.size()) {
+                    throw JniException("Not enough room to copy the elements of a matrix");
+                }
+                easyjni::JavaArray<T>(row).getRegion(context, 0, elements.subspan(offset, length));
+                offset += length;
+                return !context.getEnvironment()->ExceptionCheck();
+            });
+            return offset;
+        }
+
+        /**
+         * Copies all the elements of this matrix into a vector, row after row.
+         *
+         * @return The vector containing the elements of this matrix.
+         *
+         * @throws JniException If a row is null, or if an error occurred while
+         *         copying the elements.
+         */
+        std::vector<T> toVector() {
+            return toVector(JavaVirtualMachineRegistry::getContext());
+        }
+
+        /**
+         * Copies all the elements of this matrix into a vector, row after row, using
+         * the given context.
+         *
+         * @param context The context of the current thread.
+         *
+         * @return The vector containing the elements of this matrix.
+         *
+         * @throws JniException If a row is null, or if an error occurred while
+         *         copying the elements and the context checks exceptions immediately.
+         */
+        std::vector<T> toVector(const easyjni::JavaContext &context) {
+            std::vector<T> elements;
+            forEachRow(context, [&](jarray row, int length) {
+                auto offset = elements.size();
+                elements.resize(offset + length);
+                easyjni::JavaArray<T>(row).getRegion(context, 0, std::span<T>(elements).subspan(offset));
+                return !context.getEnvironment()->ExceptionCheck();
+            });
+            return elements;
+        }
+
+        /**
+         * Replaces all the elements of this matrix with those of the given buffer,
+         * in which rows are stored one after the other.
+         * The shape of the matrix is not modified.
+         *
+         * @param elements The new elements of this matrix.
+         *
+         * @throws JniException If the size of the buffer does not match the number
+         *         of elements in the matrix, if a row is null, or if an error occurred
+         *         while copying the elements.
+         */
+        void copyFrom(std::span<const T> elements) {
+            copyFrom(JavaVirtualMachineRegistry::getContext(), elements);
+        }
+
+        /**
+         * Replaces all the elements of this matrix with those of the given buffer,
+         * in which rows are stored one after the other, using the given context.
+         * The shape of the matrix is not modified.
+         *
+         * @param context The context of the current thread.
+         * @param elements The new elements of this matrix.
+         *
+         * @throws JniException If the size of the buffer does not match the number
+         *         of elements in the matrix, if a row is null, or if an error occurred
+         *         while copying the elements and the context checks exceptions
+         *         immediately.
+         */
+        void copyFrom(const easyjni::JavaContext &context, std::span<const T> elements) {
+            std::size_t offset = 0;
+            bool completed = forEachRow(context, [&](jarray row, int length) {
+                if (offset + length > elements.size()) {
+                    throw JniException("Not enough elements to fill a matrix");
+                }
+                easyjni::JavaArray<T>(row).setRegion(context, 0, elements.subspan(offset, length));
+                offset += length;
+                return !context.getEnvironment()->ExceptionCheck();
+            });
+            if (completed && (offset != elements.size())) {
+                throw JniException("Too many elements to fill a matrix");
+            }
+        }
+
+        /**
+         * Gives the native pointer to the array of rows in the Java Virtual Machine.
+         *
+         * @return The native pointer to the array of rows.
+         */
+        jobjectArray operator*() {
+            return rows;
+        }
+
+    private:
+
+        /**
+         * Applies a function to each row of this matrix, in order.
+         * The local reference to each row is deleted once the function has been
+         * applied to it.
+         *
+         * @tparam Function The type of the function to apply, which takes the row
+         *         and its length, and returns whether the iteration should continue.
+         *
+         * @param context The context of the current thread.
+         * @param function The function to apply to each row.
+         *
+         * @return Whether all the rows have been visited.
+         *
+         * @throws JniException If a row is null, or if an error occurred while
+         *         reading a row and the context checks exceptions immediately.
+         */
+        template<typename Function>
+        bool forEachRow(const easyjni::JavaContext &context, Function function) {
+            auto env = context.getEnvironment();
+            int nbRows = env->GetArrayLength(rows);
+            for (int i = 0; i < nbRows; i++) {
+                auto row = (jarray) env->GetObjectArrayElement(rows, i);
+                if (row == nullptr) {
+                    if (env->ExceptionCheck()) {
+                        context.afterCall();
+                        return false;
+                    }
+                    throw JniException("Row #" + std::to_string(i) + " of a matrix is null");
+                }
+
+                bool proceed;
+                try {
+                    proceed = function(row, env->GetArrayLength(row));
+                } catch (...) {
+                    env->DeleteLocalRef(row);
+                    throw;
+                }
+                env->DeleteLocalRef(row);
+                if (!proceed) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * Creates a new row in the Java Virtual Machine.
+         *
+         * @param env The native Java Environment provided by JNI.
+         * @param length The length of the row.
+         *
+         * @return The created row, or nullptr if it could not be created.
+         */
+        static jarray newRow(JNIEnv *env, jsize length) {
+            if constexpr (std::is_same_v<T, jboolean>) {
+                return env->NewBooleanArray(length);
+            } else if constexpr (std::is_same_v<T, jbyte>) {
+                return env->NewByteArray(length);
+            } else if constexpr (std::is_same_v<T, jchar>) {
+                return env->NewCharArray(length);
+            } else if constexpr (std::is_same_v<T, jshort>) {
+                return env->NewShortArray(length);
+            } else if constexpr (std::is_same_v<T, jint>) {
+                return env->NewIntArray(length);
+            } else if constexpr (std::is_same_v<T, jlong>) {
+                return env->NewLongArray(length);
+            } else if constexpr (std::is_same_v<T, jfloat>) {
+                return env->NewFloatArray(length);
+            } else {
+                static_assert(std::is_same_v<T, jdouble>, "Matrices can only contain primitive values");
+                return env->NewDoubleArray(length);
+            }
+        }
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,311 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#ifndef EASYJNI_JAVAMEMBERCACHE_H
+#define EASYJNI_JAVAMEMBERCACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <jni.h>
+
+namespace easyjni {
+
+    /**
+     * The JavaMemberCache stores the native identifiers of the fields and methods
+     * that have already been looked up, indexed by their name and signature, and
+     * identified by the reference of their class.
+     * Lookups in this cache do not take any lock: entries are never modified once
+     * they have been published, and only insertions are serialized.
+     * Entries removed from the cache are retired rather than freed, as concurrent
+     * lookups may still be traversing them: they are only reclaimed when no lookup
+     * may happen anymore, i.e., when the Java Virtual Machine is destroyed.
+     *
+     * As different class loaders may define classes with the same name, classes
+     * are compared by reference (through a weak global reference) rather than by
+     * name, which also allows to cache the members of the classes whose name is
+     * unknown (e.g., the classes obtained with JavaObject::getClass()).
+     * Names are only used to skip the entries of other classes without calling
+     * JNI, when they are known on both sides.
+     *
+     * @author Romain Wallon
+     *
+     * @version 0.1.0
+     */
+    class JavaMemberCache {
+
+    public:
+
+        /**
+         * The Kind enumerates the different kinds of members stored in the cache.
+         */
+        enum class Kind {
+
+            /**
+             * The member is an instance field.
+             */
+            FIELD,
+
+            /**
+             * The member is a static field.
+             */
+            STATIC_FIELD,
+
+            /**
+             * The member is an instance method (or a constructor).
+             */
+            METHOD,
+
+            /**
+             * The member is a static method.
+             */
+            STATIC_METHOD
+
+        };
+
+    private:
+
+        /**
+         * The Entry is an (immutable) entry of the cache.
+         */
+        struct Entry {
+
+            /**
+             * The hash of the key of this entry.
+             */
+            std::size_t hash;
+
+            /**
+             * The kind of the cached member.
+             */
+            Kind kind;
+
+            /**
+             * The name of the class declaring the cached member, as known when the
+             * member has been cached.
+             */
+            std::string className;
+
+            /**
+             * The weak global reference to the class declaring the cached member,
+             * which identifies this class.
+             */
+            jweak nativeClass;
+
+            /**
+             * The name of the cached member.
+             */
+            std::string name;
+
+            /**
+             * The signature of the cached member.
+             */
+            std::string signature;
+
+            /**
+             * The native identifier of the cached member.
+             */
+            void *id;
+
+            /**
+             * The next entry in the same bucket.
+             */
+            std::atomic<Entry *> next;
+
+        };
+
+        /**
+         * The number of buckets in the cache.
+         */
+        static constexpr std::size_t NB_BUCKETS = 1024;
+
+        /**
+         * The buckets of the cache, each of them being a linked list of entries.
+         */
+        static std::atomic<Entry *> buckets[NB_BUCKETS];
+
+        /**
+         * The number of entries in the cache.
+         */
+        static std::atomic<std::size_t> nbEntries;
+
+        /**
+         * The number of lookups that found their member in the cache.
+         */
+        static std::atomic<unsigned long long> hits;
+
+        /**
+         * The number of lookups that did not find their member in the cache.
+         */
+        static std::atomic<unsigned long long> misses;
+
+        /**
+         * The entries that have been removed from the cache, and that are waiting
+         * to be reclaimed.
+         */
+        static std::vector<Entry *> retired;
+
+        /**
+         * The mutex used to serialize the insertions in (and removals from) the cache.
+         */
+        static std::mutex mutex;
+
+    public:
+
+        /**
+         * Disables instantiation.
+         */
+        JavaMemberCache() = delete;
+
+        /**
+         * Gives the number of lookups that found their member in the cache.
+         *
+         * @return The number of cache hits.
+         */
+        static unsigned long long getHits();
+
+        /**
+         * Gives the number of lookups that did not find their member in the cache.
+         *
+         * @return The number of cache misses.
+         */
+        static unsigned long long getMisses();
+
+        /**
+         * Gives the number of members stored in the cache.
+         *
+         * @return The size of the cache.
+         */
+        static std::size_t size();
+
+        /**
+         * Removes all members from the cache, and resets its counters.
+         * The removed entries are retired, so that this method may safely be called
+         * while other threads look up members.
+         */
+        static void clear();
+
+        /**
+         * Removes all the members of the given class from the cache.
+         * Only the members cached under the name of the class are removed, which
+         * excludes those looked up through a class whose name was unknown.
+         * The removed entries are retired, so that this method may safely be called
+         * while other threads look up members.
+         *
+         * @param className The name of the class whose members are to be removed.
+         */
+        static void invalidate(std::string_view className);
+
+        /**
+         * Frees all the entries that have been retired from the cache.
+         * This method must not be called while other threads may look up members.
+         *
+         * @param env The environment used to delete the references to the classes.
+         */
+        static void reclaim(JNIEnv *env);
+
+    private:
+
+        /**
+         * Checks whether the name of a class is known, i.e., whether it is the name
+         * under which the class has been loaded.
+         *
+         * @param className The name of the class.
+         *
+         * @return Whether the name of the class is known.
+         */
+        static bool isNamed(std::string_view className);
+
+        /**
+         * Computes the hash of the key of a member.
+         * The class declaring the member is not part of the key, as it is identified
+         * by reference.
+         *
+         * @param kind The kind of the member.
+         * @param name The name of the member.
+         * @param signature The signature of the member.
+         *
+         * @return The hash of the key.
+         */
+        static std::size_t hash(Kind kind, std::string_view name, std::string_view signature);
+
+        /**
+         * Looks up a member in the cache.
+         *
+         * @param env The environment used to compare the classes.
+         * @param kind The kind of the member.
+         * @param nativeClass The class declaring the member.
+         * @param className The name of the class declaring the member.
+         * @param name The name of the member.
+         * @param signature The signature of the member.
+         *
+         * @return The native identifier of the member, or nullptr if it is not in the cache.
+         */
+        static void *find(JNIEnv *env, Kind kind, jclass nativeClass, std::string_view className,
+                          std::string_view name, std::string_view signature);
+
+        /**
+         * Stores a member in the cache.
+         * If the member has been stored by another thread in the meantime, the cache
+         * is not modified.
+         *
+         * @param env The environment used to compare and reference the classes.
+         * @param kind The kind of the member.
+         * @param nativeClass The class declaring the member.
+         * @param className The name of the class declaring the member.
+         * @param name The name of the member.
+         * @param signature The signature of the member.
+         * @param id The native identifier of the member.
+         */
+        static void insert(JNIEnv *env, Kind kind, jclass nativeClass, std::string_view className,
+                           std::string_view name, std::string_view signature, void *id);
+
+        /**
+         * Looks up an entry in the given bucket.
+         *
+         * @param env The environment used to compare the classes.
+         * @param head The first entry of the bucket.
+         * @param h The hash of the key of the member.
+         * @param kind The kind of the member.
+         * @param nativeClass The class declaring the member.
+         * @param className The name of the class declaring the member.
+         * @param name The name of the member.
+         * @param signature The signature of the member.
+         *
+         * @return The entry of the member, or nullptr if it is not in the bucket.
+         */
+        static Entry *findEntry(JNIEnv *env, Entry *head, std::size_t h, Kind kind, jclass nativeClass,
+                                std::string_view className, std::string_view name, std::string_view signature);
+
+        /**
+         * The JavaClass is a friend class, which uses the cache to look up the
+         * members it declares.
+         */
+        friend class JavaClass;
+
+    };
+
+}
+
+#endif
@@ -21,13 +21,19 @@
 #ifndef EASYJNI_JAVAMETHOD_H
 #define EASYJNI_JAVAMETHOD_H
 
-#include <cstdarg>
-#include <functional>
+#include <algorithm>
+#include <cstddef>
+#include <span>
 #include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 #include <jni.h>
 
+#include "JavaArguments.h"
 #include "JavaClass.h"
+#include "JavaContext.h"
 #include "JavaElement.h"
 #include "JavaObject.h"
 #include "JniException.h"
@@ -55,14 +61,17 @@ namespace easyjni {
         jmethodID nativeMethod;
 
         /**
-         * The function to use to invoke this (instance) method on a particular object.
+         * Whether this method is a constructor.
          */
-        std::function<T(JNIEnv *, jobject, jmethodID, va_list)> call;
+        bool constructor;
+
+    public:
 
         /**
-         * The function to use to invoke this (static) method on its class.
+         * The number of invocations performed in a single local frame when this
+         * method is invoked in batch.
          */
-        std::function<T(JNIEnv *, jclass, jmethodID, va_list)> staticCall;
+        static constexpr std::size_t BATCH_CHUNK_SIZE = 512;
 
     private:
 
@@ -71,16 +80,12 @@ namespace easyjni {
          *
          * @param name The name of the method.
          * @param nativeMethod The native pointer to the method in the Java Virtual Machine.
-         * @param call The function to use to invoke this (instance) method on a particular object.
-         * @param staticCall The function to use to invoke this (static) method on its class.
+         * @param constructor Whether the method is a constructor.
          */
-        explicit JavaMethod(std::string name, jmethodID nativeMethod,
-                   std::function<T(JNIEnv *, jobject, jmethodID, va_list)> call,
-                   std::function<T(JNIEnv *, jclass, jmethodID, va_list)> staticCall) :
+        explicit JavaMethod(std::string name, jmethodID nativeMethod, bool constructor = false) :
                 JavaElement(std::move(name)),
                 nativeMethod(nativeMethod),
-                call(call),
-                staticCall(staticCall) {
+                constructor(constructor) {
             // Nothing to do: everything is already initialized.
         }
 
@@ -92,48 +97,434 @@ namespace easyjni {
          *
          * @return The created JavaMethod.
          */
-        static JavaMethod<T> newInstance(std::string name, jmethodID nativeMethod);
+        static JavaMethod<T> newInstance(std::string name, jmethodID nativeMethod) {
+            return JavaMethod<T>(std::move(name), nativeMethod);
+        }
 
     public:
 
         /**
          * Invokes this method on the given object.
          *
+         * @tparam Args The types of the parameters to give to this method.
+         *
          * @param object The object on which to invoke this method.
-         * @param ... The parameters to give to this method.
+         * @param args The parameters to give to this method.
          *
          * @return The value returned by the method.
          *
          * @throws JniException If an error occurred while invoking the method.
          */
-        T invoke(easyjni::JavaObject object, ...) {
-            va_list args;
-            va_start(args, object);
-            T result = call(getEnvironment(), *object, nativeMethod, args);
-            va_end(args);
-            checkException();
+        template<typename... Args>
+        T invoke(easyjni::JavaObject object, Args &&... args) {
+            return invoke(easyjni::JavaContext(getEnvironment()), object, std::forward<Args>(args)...);
+        }
+
+        /**
+         * Invokes this method on the given object, using the given context.
+         *
+         * @tparam Args The types of the parameters to give to this method.
+         *
+         * @param context The context of the current thread.
+         * @param object The object on which to invoke this method.
+         * @param args The parameters to give to this method.
+         *
+         * @return The value returned by the method.
+         *
+         * @throws JniException If an error occurred while invoking the method, and
+         *         the context checks exceptions immediately.
+         */
+        template<typename... Args>
+        T invoke(const easyjni::JavaContext &context, easyjni::JavaObject object, Args &&... args) {
+            if (constructor) {
+                throw JniException("Cannot invoke a constructor on an instance");
+            }
+
+            auto env = context.getEnvironment();
+            T result = call(env, *object, JavaArguments<sizeof...(Args)>(env, std::forward<Args>(args)...).data());
+            context.afterCall();
             return result;
         }
 
         /**
          * Statically invokes this method on the given class.
          *
+         * @tparam Args The types of the parameters to give to this method.
+         *
          * @param clazz The class on which to invoke this method.
-         * @param ... The parameters to give to this method.
+         * @param args The parameters to give to this method.
          *
          * @return The value returned by the method.
          *
          * @throws JniException If an error occurred while invoking the method.
          */
-        T invokeStatic(easyjni::JavaClass clazz, ...) {
-            va_list args;
-            va_start(args, clazz);
-            T result = staticCall(getEnvironment(), *clazz, nativeMethod, args);
-            va_end(args);
-            checkException();
+        template<typename... Args>
+        T invokeStatic(easyjni::JavaClass clazz, Args &&... args) {
+            return invokeStatic(easyjni::JavaContext(getEnvironment()), clazz, std::forward<Args>(args)...);
+        }
+
+        /**
+         * Statically invokes this method on the given class, using the given context.
+         *
+         * @tparam Args The types of the parameters to give to this method.
+         *
+         * @param context The context of the current thread.
+         * @param clazz The class on which to invoke this method.
+         * @param args The parameters to give to this method.
+         *
+         * @return The value returned by the method.
+         *
+         * @throws JniException If an error occurred while invoking the method, and
+         *         the context checks exceptions immediately.
+         */
+        template<typename... Args>
+        T invokeStatic(const easyjni::JavaContext &context, easyjni::JavaClass clazz, Args &&... args) {
+            auto env = context.getEnvironment();
+            T result = callStatic(env, *clazz, JavaArguments<sizeof...(Args)>(env, std::forward<Args>(args)...).data());
+            context.afterCall();
             return result;
         }
 
+        /**
+         * Invokes this method on each of the given objects, with the same parameters.
+         *
+         * @tparam Args The types of the parameters to give to this method.
+         *
+         * @param receivers The objects on which to invoke this method.
+         * @param results The span in which to write the value returned by each invocation.
+         *        It may be empty if the method returns void.
+         * @param args The parameters to give to this method.
+         *
+         * @return The number of successful invocations, i.e., the number of receivers.
+         *
+         * @throws JniException If an error occurred while invoking the method, which
+         *         identifies the first receiver for which the invocation failed.
+         */
+        template<typename... Args>
+        std::size_t invokeBatch(std::span<const easyjni::JavaObject> receivers, std::span<T> results, Args &&... args) {
+            return invokeBatch(easyjni::JavaContext(getEnvironment()), receivers, results, std::forward<Args>(args)...);
+        }
+
+        /**
+         * Invokes this method on each of the given objects, with the same parameters,
+         * using the given context.
+         * The parameters are converted only once for all invocations.
+         *
+         * @tparam Args The types of the parameters to give to this method.
+         *
+         * @param context The context of the current thread.
+         * @param receivers The objects on which to invoke this method.
+         * @param results The span in which to write the value returned by each invocation.
+         *        It may be empty if the method returns void.
+         * @param args The parameters to give to this method.
+         *
+         * @return The number of successful invocations, which is also the index of the
+         *         receiver for which the invocation failed (if any).
+         *
+         * @throws JniException If an error occurred while invoking the method, and
+         *         the context checks exceptions immediately.
+         */
+        template<typename... Args>
+        std::size_t invokeBatch(const easyjni::JavaContext &context, std::span<const easyjni::JavaObject> receivers,
+                                std::span<T> results, Args &&... args) {
+            if (constructor) {
+                throw JniException("Cannot invoke a constructor on an instance");
+            }
+
+            JavaArguments<sizeof...(Args)> arguments(context.getEnvironment(), std::forward<Args>(args)...);
+            return batch(context, receivers.size(), results, [&](JNIEnv *env, std::size_t i) {
+                easyjni::JavaObject receiver = receivers[i];
+                return call(env, *receiver, arguments.data());
+            });
+        }
+
+        /**
+         * Invokes this method on the given object, once for each tuple of parameters.
+         *
+         * @tparam Tuple The type of the tuples of parameters.
+         * @tparam Extent The number of tuples, if known at compile-time.
+         *
+         * @param receiver The object on which to invoke this method.
+         * @param arguments The tuples of parameters to give to this method.
+         * @param results The span in which to write the value returned by each invocation.
+         *        It may be empty if the method returns void.
+         *
+         * @return The number of successful invocations, i.e., the number of tuples.
+         *
+         * @throws JniException If an error occurred while invoking the method, which
+         *         identifies the first tuple for which the invocation failed.
+         */
+        template<typename Tuple, std::size_t Extent>
+        std::size_t invokeBatch(easyjni::JavaObject receiver, std::span<Tuple, Extent> arguments, std::span<T> results) {
+            return invokeBatch(easyjni::JavaContext(getEnvironment()), receiver, arguments, results);
+        }
+
+        /**
+         * Invokes this method on the given object, once for each tuple of parameters,
+         * using the given context.
+         *
+         * @tparam Tuple The type of the tuples of parameters.
+         * @tparam Extent The number of tuples, if known at compile-time.
+         *
+         * @param context The context of the current thread.
+         * @param receiver The object on which to invoke this method.
+         * @param arguments The tuples of parameters to give to this method.
+         * @param results The span in which to write the value returned by each invocation.
+         *        It may be empty if the method returns void.
+         *
+         * @return The number of successful invocations, which is also the index of the
+         *         tuple for which the invocation failed (if any).
+         *
+         * @throws JniException If an error occurred while invoking the method, and
+         *         the context checks exceptions immediately.
+         */
+        template<typename Tuple, std::size_t Extent>
+        std::size_t invokeBatch(const easyjni::JavaContext &context, easyjni::JavaObject receiver,
+                                std::span<Tuple, Extent> arguments, std::span<T> results) {
+            if (constructor) {
+                throw JniException("Cannot invoke a constructor on an instance");
+            }
+
+            return batch(context, arguments.size(), results, [&](JNIEnv *env, std::size_t i) {
+                return std::apply([&](const auto &... args) {
+                    return call(env, *receiver, JavaArguments<sizeof...(args)>(env, args...).data());
+                }, arguments[i]);
+            });
+        }
+
+        /**
+         * Statically invokes this method on the given class, once for each tuple of
+         * parameters.
+         *
+         * @tparam Tuple The type of the tuples of parameters.
+         * @tparam Extent The number of tuples, if known at compile-time.
+         *
+         * @param clazz The class on which to invoke this method.
+         * @param arguments The tuples of parameters to give to this method.
+         * @param results The span in which to write the value returned by each invocation.
+         *        It may be empty if the method returns void.
+         *
+         * @return The number of successful invocations, i.e., the number of tuples.
+         *
+         * @throws JniException If an error occurred while invoking the method, which
+         *         identifies the first tuple for which the invocation failed.
+         */
+        template<typename Tuple, std::size_t Extent>
+        std::size_t invokeStaticBatch(easyjni::JavaClass clazz, std::span<Tuple, Extent> arguments,
+                                      std::span<T> results) {
+            return invokeStaticBatch(easyjni::JavaContext(getEnvironment()), clazz, arguments, results);
+        }
+
+        /**
+         * Statically invokes this method on the given class, once for each tuple of
+         * parameters, using the given context.
+         *
+         * @tparam Tuple The type of the tuples of parameters.
+         * @tparam Extent The number of tuples, if known at compile-time.
+         *
+         * @param context The context of the current thread.
+         * @param clazz The class on which to invoke this method.
+         * @param arguments The tuples of parameters to give to this method.
+         * @param results The span in which to write the value returned by each invocation.
+         *        It may be empty if the method returns void.
+         *
+         * @return The number of successful invocations, which is also the index of the
+         *         tuple for which the invocation failed (if any).
+         *
+         * @throws JniException If an error occurred while invoking the method, and
+         *         the context checks exceptions immediately.
+         */
+        template<typename Tuple, std::size_t Extent>
+        std::size_t invokeStaticBatch(const easyjni::JavaContext &context, easyjni::JavaClass clazz,
+                                      std::span<Tuple, Extent> arguments, std::span<T> results) {
+            return batch(context, arguments.size(), results, [&](JNIEnv *env, std::size_t i) {
+                return std::apply([&](const auto &... args) {
+                    return callStatic(env, *clazz, JavaArguments<sizeof...(args)>(env, args...).data());
+                }, arguments[i]);
+            });
+        }
+
+    private:
+
+        /**
+         * Performs a batch of invocations of this method, by chunks of BATCH_CHUNK_SIZE
+         * invocations.
+         * Each chunk runs in its own local frame, so that the local references created
+         * by the invocations are released at the end of the chunk.
+         * The objects returned by the method are the exception: they are kept in the
+         * current frame (after having ensured its capacity), as they are given back
+         * to the caller.
+         * The batch stops at the first invocation throwing a Java exception, as no
+         * other call to JNI may be performed while this exception is pending.
+         *
+         * @tparam Invoke The type of the function performing a single invocation.
+         *
+         * @param context The context of the current thread.
+         * @param size The number of invocations to perform.
+         * @param results The span in which to write the value returned by each invocation.
+         * @param invoke The function performing the invocation at a given index.
+         *
+         * @return The number of successful invocations.
+         *
+         * @throws JniException If an error occurred while invoking the method, and
+         *         the context checks exceptions immediately.
+         */
+        template<typename Invoke>
+        std::size_t batch(const easyjni::JavaContext &context, std::size_t size, std::span<T> results, Invoke invoke) {
+            constexpr bool isVoid = std::is_same_v<T, void *>;
+            constexpr bool isObject = std::is_same_v<T, easyjni::JavaObject>;
+            if ((results.size() < size) && !(isVoid && results.empty())) {
+                throw JniException("Not enough room to store the results of a batch of " + getName());
+            }
+
+            auto env = context.getEnvironment();
+            for (std::size_t start = 0; start < size; start += BATCH_CHUNK_SIZE) {
+                std::size_t end = std::min(size, start + BATCH_CHUNK_SIZE);
+                auto capacity = static_cast<jint>(end - start);
+                jint frame = isObject ? env->EnsureLocalCapacity(capacity) : env->PushLocalFrame(capacity);
+                if (frame < 0) {
+                    context.checkException();
+                    throw JniException("Could not allocate local references for a batch of " + getName());
+                }
+
+                // Performing the invocations of the chunk.
+                std::size_t i = start;
+                {
+                    // The frame of the chunk is popped even if an invocation throws.
+                    struct FrameGuard {
+                        JNIEnv *env;
+                        bool pushed;
+                        ~FrameGuard() {
+                            if (pushed) {
+                                env->PopLocalFrame(nullptr);
+                            }
+                        }
+                    } guard {env, !isObject};
+
+                    for (; i < end; i++) {
+                        T result = invoke(env, i);
+                        if (env->ExceptionCheck()) {
+                            break;
+                        }
+                        if (!results.empty()) {
+                            results[i] = result;
+                        }
+                    }
+                }
+
+                // Reporting the first failure, if any.
+                if (i < end) {
+                    if (context.getExceptionPolicy() == easyjni::JavaContext::ExceptionPolicy::IMMEDIATE) {
+                        try {
+                            context.checkException();
+                        } catch (JniException &e) {
+                            throw JniException("Invocation #" + std::to_string(i) + " in a batch of "
+                                               + getName() + " failed: " + e.what());
+                        }
+                    }
+                    return i;
+                }
+            }
+            return size;
+        }
+
+        /**
+         * Invokes this (instance) method on a particular object.
+         *
+         * @param env The native Java Environment provided by JNI.
+         * @param object The object on which to invoke this method.
+         * @param args The packed parameters to give to this method.
+         *
+         * @return The value returned by the method.
+         */
+        T call(JNIEnv *env, jobject object, const jvalue *args) {
+            if constexpr (std::is_same_v<T, void *>) {
+                env->CallVoidMethodA(object, nativeMethod, args);
+                return nullptr;
+
+            } else if constexpr (std::is_same_v<T, jboolean>) {
+                return env->CallBooleanMethodA(object, nativeMethod, args);
+
+            } else if constexpr (std::is_same_v<T, jbyte>) {
+                return env->CallByteMethodA(object, nativeMethod, args);
+
+            } else if constexpr (std::is_same_v<T, jchar>) {
+                return env->CallCharMethodA(object, nativeMethod, args);
+
+            } else if constexpr (std::is_same_v<T, jshort>) {
+                return env->CallShortMethodA(object, nativeMethod, args);
+
+            } else if constexpr (std::is_same_v<T, jint>) {
+                return env->CallIntMethodA(object, nativeMethod, args);
+
+            } else if constexpr (std::is_same_v<T, jlong>) {
+                return env->CallLongMethodA(object, nativeMethod, args);
+
+            } else if constexpr (std::is_same_v<T, jfloat>) {
+                return env->CallFloatMethodA(object, nativeMethod, args);
+
+            } else if constexpr (std::is_same_v<T, jdouble>) {
+                return env->CallDoubleMethodA(object, nativeMethod, args);
+
+            } else {
+                static_assert(std::is_same_v<T, easyjni::JavaObject>, "Unsupported return type");
+                return easyjni::JavaObject(env->CallObjectMethodA(object, nativeMethod, args));
+            }
+        }
+
+        /**
+         * Invokes this (static) method on its class.
+         *
+         * @param env The native Java Environment provided by JNI.
+         * @param clazz The class on which to invoke this method.
+         * @param args The packed parameters to give to this method.
+         *
+         * @return The value returned by the method.
+         */
+        T callStatic(JNIEnv *env, jclass clazz, const jvalue *args) {
+            if constexpr (std::is_same_v<T, void *>) {
+                env->CallStaticVoidMethodA(clazz, nativeMethod, args);
+                return nullptr;
+
+            } else if constexpr (std::is_same_v<T, jboolean>) {
+                return env->CallStaticBooleanMethodA(clazz, nativeMethod, args);
+
+            } else if constexpr (std::is_same_v<T, jbyte>) {
+                return env->CallStaticByteMethodA(clazz, nativeMethod, args);
+
+            } else if constexpr (std::is_same_v<T, jchar>) {
+                return env->CallStaticCharMethodA(clazz, nativeMethod, args);
+
+            } else if constexpr (std::is_same_v<T, jshort>) {
+                return env->CallStaticShortMethodA(clazz, nativeMethod, args);
+
+            } else if constexpr (std::is_same_v<T, jint>) {
+                return env->CallStaticIntMethodA(clazz, nativeMethod, args);
+
+            } else if constexpr (std::is_same_v<T, jlong>) {
+                return env->CallStaticLongMethodA(clazz, nativeMethod, args);
+
+            } else if constexpr (std::is_same_v<T, jfloat>) {
+                return env->CallStaticFloatMethodA(clazz, nativeMethod, args);
+
+            } else if constexpr (std::is_same_v<T, jdouble>) {
+                return env->CallStaticDoubleMethodA(clazz, nativeMethod, args);
+
+            } else if (constructor) {
+                return easyjni::JavaObject(env->NewObjectA(clazz, nativeMethod, args));
+
+            } else {
+                static_assert(std::is_same_v<T, easyjni::JavaObject>, "Unsupported return type");
+                return easyjni::JavaObject(env->CallStaticObjectMethodA(clazz, nativeMethod, args));
+            }
+        }
+
+        /**
+         * The JavaBulkDispatcher is a friend class, which records invocations of
+         * methods to execute them in batch.
+         */
+        friend class JavaBulkDispatcher;
+
         /**
          * The JavaClass is a friend class, which uses JavaMethod to represent
          * the methods it declares.
@@ -142,6 +533,11 @@ namespace easyjni {
 
     };
 
+    /**
+     * Methods may be stored by thousands in flat tables, so their handles must remain plain values.
+     */
+    static_assert(std::is_trivially_copyable_v<easyjni::JavaMethod<jint>>, "Java method handles must be trivially copyable");
+
 }
 
 #endif
@@ -147,12 +147,30 @@ namespace easyjni {
          */
         template<typename T> friend class JavaArray;
 
+        /**
+         * The JavaBulkDispatcher is a friend class, which allows to retrieve the
+         * objects shared with the calls it executes.
+         */
+        friend class JavaBulkDispatcher;
+
         /**
          * The JavaClass is a friend class, which allows to build instances of JavaObject
          * by invoking methods on such objects.
          */
         friend class JavaClass;
 
+        /**
+         * The JavaContext is a friend class, which allows to create instances of
+         * JavaObject when an exception is thrown by the JVM.
+         */
+        friend class JavaContext;
+
+        /**
+         * The JavaDirectBuffer is a friend class, which allows to retrieve the
+         * buffers it creates as instances of JavaObject.
+         */
+        friend class JavaDirectBuffer;
+
         /**
          * The JavaField is a friend class, which allows to access to the fields of
          * an object.
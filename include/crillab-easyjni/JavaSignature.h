@@ -21,6 +21,10 @@
 #ifndef EASYJNI_JAVASIGNATURE_H
 #define EASYJNI_JAVASIGNATURE_H
 
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+
 #include <jni.h>
 
 #define BOOLEAN     "Z"
@@ -41,4 +45,380 @@
 #define CONSTRUCTOR(arguments)      "(" arguments ")V"
 #define METHOD(returnType, ...)     "(" __VA_ARGS__ ")" returnType
 
+namespace easyjni {
+
+    /**
+     * Forward declaration of JavaObject, the class that represents an object
+     * from the Java Virtual Machine.
+     */
+    class JavaObject;
+
+    /**
+     * Forward declaration of JavaClass, the class that represents a class
+     * from the Java Virtual Machine.
+     */
+    class JavaClass;
+
+    /**
+     * Forward declaration of JavaArray, the class that represents an array
+     * from the Java Virtual Machine.
+     */
+    template<typename T>
+    class JavaArray;
+
+    /**
+     * Checks whether a type is always false, which allows to trigger static
+     * assertions in discarded branches only.
+     *
+     * @tparam T The type to check.
+     */
+    template<typename T>
+    inline constexpr bool alwaysFalse = false;
+
+    /**
+     * The JavaDescriptor is a string of fixed size, which is built at compile-time
+     * to represent the descriptor of a Java type or method.
+     *
+     * @tparam N The number of characters in the descriptor.
+     *
+     * @author Romain Wallon
+     *
+     * @version 0.1.0
+     */
+    template<std::size_t N>
+    struct JavaDescriptor {
+
+        /**
+         * The characters of the descriptor, followed by a null character.
+         */
+        char value[N + 1] = {};
+
+        /**
+         * Creates an empty JavaDescriptor.
+         */
+        constexpr JavaDescriptor() = default;
+
+        /**
+         * Creates a new JavaDescriptor.
+         *
+         * @param str The string literal representing the descriptor.
+         */
+        constexpr JavaDescriptor(const char (&str)[N + 1]) {
+            for (std::size_t i = 0; i < N; i++) {
+                value[i] = str[i];
+            }
+        }
+
+        /**
+         * Gives the number of characters in this descriptor.
+         *
+         * @return The size of this descriptor.
+         */
+        [[nodiscard]] constexpr std::size_t size() const {
+            return N;
+        }
+
+        /**
+         * Gives this descriptor as a null-terminated string.
+         *
+         * @return The null-terminated string representing this descriptor.
+         */
+        [[nodiscard]] constexpr const char *c_str() const {
+            return value;
+        }
+
+        /**
+         * Gives a view of this descriptor.
+         *
+         * @return The view of this descriptor.
+         */
+        constexpr operator std::string_view() const {
+            return {value, N};
+        }
+
+        /**
+         * Concatenates this descriptor with another one.
+         *
+         * @tparam M The number of characters in the other descriptor.
+         *
+         * @param other The descriptor to append to this descriptor.
+         *
+         * @return The concatenation of the two descriptors.
+         */
+        template<std::size_t M>
+        constexpr JavaDescriptor<N + M> operator+(const JavaDescriptor<M> &other) const {
+            JavaDescriptor<N + M> result;
+            for (std::size_t i = 0; i < N; i++) {
+                result.value[i] = value[i];
+            }
+            for (std::size_t i = 0; i < M; i++) {
+                result.value[N + i] = other.value[i];
+            }
+            return result;
+        }
+
+    };
+
+    /**
+     * Deduces the size of a JavaDescriptor from a string literal.
+     */
+    template<std::size_t N>
+    JavaDescriptor(const char (&)[N]) -> JavaDescriptor<N - 1>;
+
+    /**
+     * Checks whether the given name is a valid internal name for a Java class,
+     * such as "java/lang/String".
+     *
+     * @param name The name to check.
+     *
+     * @return Whether the name is a valid internal class name.
+     */
+    consteval bool isValidClassName(std::string_view name) {
+        if (name.empty() || (name.front() == '/') || (name.back() == '/')) {
+            return false;
+        }
+
+        for (std::size_t i = 0; i < name.size(); i++) {
+            char c = name[i];
+            if ((c == '.') || (c == ';') || (c == '[') || (c == '(') || (c == ')') || (c == '<') || (c == '>')) {
+                return false;
+            }
+            if ((c == '/') && (name[i + 1] == '/')) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * The JavaReference is a tag type that represents, in a Signature, a reference
+     * to an instance of the Java class with the given (internal) name.
+     * The name is checked at compile-time.
+     *
+     * @tparam Name The internal name of the class, such as "java/lang/String".
+     */
+    template<JavaDescriptor Name> requires (isValidClassName(Name))
+    struct JavaReference {};
+
+    /**
+     * The tag type representing java.lang.Object in a Signature.
+     */
+    using JObject = easyjni::JavaReference<"java/lang/Object">;
+
+    /**
+     * The tag type representing java.lang.String in a Signature.
+     */
+    using JString = easyjni::JavaReference<"java/lang/String">;
+
+    /**
+     * The tag type representing java.lang.Class in a Signature.
+     */
+    using JClass = easyjni::JavaReference<"java/lang/Class">;
+
+    /**
+     * The JavaTypeDescriptor gives, for a C++ type, the descriptor of the
+     * corresponding Java type, together with the type used by EasyJNI to
+     * represent its values.
+     * Types that do not correspond to any Java type are rejected at compile-time.
+     *
+     * @tparam T The C++ type to describe.
+     */
+    template<typename T>
+    struct JavaTypeDescriptor {
+        static_assert(alwaysFalse<T>, "This type does not correspond to any Java type");
+    };
+
+    /**
+     * The JavaPrimitiveDescriptor describes a primitive Java type.
+     *
+     * @tparam T The C++ type representing the primitive type.
+     * @tparam D The descriptor of the primitive type.
+     */
+    template<typename T, JavaDescriptor D>
+    struct JavaPrimitiveDescriptor {
+
+        /**
+         * The descriptor of the type.
+         */
+        static constexpr auto value = D;
+
+        /**
+         * The type used by EasyJNI to represent the values of the type.
+         */
+        using Type = T;
+
+    };
+
+    /**
+     * The JavaReferenceDescriptor describes a reference Java type.
+     *
+     * @tparam D The descriptor of the reference type.
+     */
+    template<JavaDescriptor D>
+    struct JavaReferenceDescriptor {
+
+        /**
+         * The descriptor of the type.
+         */
+        static constexpr auto value = D;
+
+        /**
+         * The type used by EasyJNI to represent the values of the type.
+         */
+        using Type = easyjni::JavaObject;
+
+    };
+
+    template<>
+    struct JavaTypeDescriptor<void> {
+        static constexpr auto value = JavaDescriptor(VOID);
+        using Type = void *;
+    };
+
+    template<>
+    struct JavaTypeDescriptor<jboolean> : JavaPrimitiveDescriptor<jboolean, BOOLEAN> {};
+
+    template<>
+    struct JavaTypeDescriptor<jbyte> : JavaPrimitiveDescriptor<jbyte, BYTE> {};
+
+    template<>
+    struct JavaTypeDescriptor<jchar> : JavaPrimitiveDescriptor<jchar, CHARACTER> {};
+
+    template<>
+    struct JavaTypeDescriptor<jshort> : JavaPrimitiveDescriptor<jshort, SHORT> {};
+
+    template<>
+    struct JavaTypeDescriptor<jint> : JavaPrimitiveDescriptor<jint, INTEGER> {};
+
+    template<>
+    struct JavaTypeDescriptor<jlong> : JavaPrimitiveDescriptor<jlong, LONG> {};
+
+    template<>
+    struct JavaTypeDescriptor<jfloat> : JavaPrimitiveDescriptor<jfloat, FLOAT> {};
+
+    template<>
+    struct JavaTypeDescriptor<jdouble> : JavaPrimitiveDescriptor<jdouble, DOUBLE> {};
+
+    template<JavaDescriptor Name>
+    struct JavaTypeDescriptor<easyjni::JavaReference<Name>> :
+            JavaReferenceDescriptor<JavaDescriptor("L") + Name + JavaDescriptor(";")> {};
+
+    template<>
+    struct JavaTypeDescriptor<easyjni::JavaObject> : JavaTypeDescriptor<easyjni::JObject> {};
+
+    template<>
+    struct JavaTypeDescriptor<jobject> : JavaTypeDescriptor<easyjni::JObject> {};
+
+    template<>
+    struct JavaTypeDescriptor<jstring> : JavaTypeDescriptor<easyjni::JString> {};
+
+    template<>
+    struct JavaTypeDescriptor<easyjni::JavaClass> : JavaTypeDescriptor<easyjni::JClass> {};
+
+    template<>
+    struct JavaTypeDescriptor<jclass> : JavaTypeDescriptor<easyjni::JClass> {};
+
+    template<typename T>
+    struct JavaTypeDescriptor<easyjni::JavaArray<T>> :
+            JavaReferenceDescriptor<JavaDescriptor("[") + JavaTypeDescriptor<T>::value> {
+        static_assert(!std::is_void_v<T>, "Arrays of void are not allowed");
+    };
+
+    template<>
+    struct JavaTypeDescriptor<jbooleanArray> : JavaTypeDescriptor<easyjni::JavaArray<jboolean>> {};
+
+    template<>
+    struct JavaTypeDescriptor<jbyteArray> : JavaTypeDescriptor<easyjni::JavaArray<jbyte>> {};
+
+    template<>
+    struct JavaTypeDescriptor<jcharArray> : JavaTypeDescriptor<easyjni::JavaArray<jchar>> {};
+
+    template<>
+    struct JavaTypeDescriptor<jshortArray> : JavaTypeDescriptor<easyjni::JavaArray<jshort>> {};
+
+    template<>
+    struct JavaTypeDescriptor<jintArray> : JavaTypeDescriptor<easyjni::JavaArray<jint>> {};
+
+    template<>
+    struct JavaTypeDescriptor<jlongArray> : JavaTypeDescriptor<easyjni::JavaArray<jlong>> {};
+
+    template<>
+    struct JavaTypeDescriptor<jfloatArray> : JavaTypeDescriptor<easyjni::JavaArray<jfloat>> {};
+
+    template<>
+    struct JavaTypeDescriptor<jdoubleArray> : JavaTypeDescriptor<easyjni::JavaArray<jdouble>> {};
+
+    template<>
+    struct JavaTypeDescriptor<jobjectArray> : JavaTypeDescriptor<easyjni::JavaArray<easyjni::JObject>> {};
+
+    /**
+     * The Signature computes at compile-time the descriptor of a Java field from
+     * the C++ type of this field, as in Signature<jint> (which is "I").
+     * The descriptor is stored in a static string of fixed size, so that no
+     * allocation is needed to look up the field.
+     *
+     * @tparam T The C++ type of the field.
+     *
+     * @author Romain Wallon
+     *
+     * @version 0.1.0
+     */
+    template<typename T>
+    struct Signature {
+        static_assert(!std::is_void_v<T>, "Fields cannot be of type void");
+
+        /**
+         * The descriptor of the field.
+         */
+        static constexpr auto descriptor = JavaTypeDescriptor<T>::value;
+
+        /**
+         * The null-terminated string representing the descriptor of the field.
+         */
+        static constexpr const char *value = descriptor.value;
+
+        /**
+         * The type used by EasyJNI to represent the values of the field.
+         */
+        using Type = typename JavaTypeDescriptor<T>::Type;
+
+    };
+
+    /**
+     * The Signature computes at compile-time the descriptor of a Java method from
+     * the C++ function type of this method, as in Signature<void(jint, JString)>
+     * (which is "(ILjava/lang/String;)V").
+     * The descriptor is stored in a static string of fixed size, so that no
+     * allocation is needed to look up the method.
+     *
+     * @tparam R The C++ return type of the method.
+     * @tparam Args The C++ types of the parameters of the method.
+     *
+     * @author Romain Wallon
+     *
+     * @version 0.1.0
+     */
+    template<typename R, typename... Args>
+    struct Signature<R(Args...)> {
+
+        /**
+         * The descriptor of the method.
+         */
+        static constexpr auto descriptor = (JavaDescriptor("(") + ... + JavaTypeDescriptor<Args>::value)
+                + JavaDescriptor(")") + JavaTypeDescriptor<R>::value;
+
+        /**
+         * The null-terminated string representing the descriptor of the method.
+         */
+        static constexpr const char *value = descriptor.value;
+
+        /**
+         * The type used by EasyJNI to represent the values returned by the method.
+         */
+        using Type = typename JavaTypeDescriptor<R>::Type;
+
+    };
+
+}
+
 #endif
@@ -21,7 +21,13 @@
 #ifndef EASYJNI_JAVAVIRTUALMACHINE_H
 #define EASYJNI_JAVAVIRTUALMACHINE_H
 
+#include <functional>
+#include <ranges>
+#include <shared_mutex>
+#include <span>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <jni.h>
 
@@ -65,6 +71,28 @@ namespace easyjni {
          */
         bool main;
 
+        /**
+         * The global references to the classes that have already been loaded,
+         * indexed by their name.
+         */
+        static std::unordered_map<std::string, jclass> classCache;
+
+        /**
+         * The maximum number of classes that can be stored in the cache.
+         */
+        static std::size_t classCacheCapacity;
+
+        /**
+         * The global references to the classes that have been removed from the cache,
+         * and that may still be used by JavaClass instances.
+         */
+        static std::vector<jclass> retiredClasses;
+
+        /**
+         * The mutex used to avoid concurrent accesses to the class cache.
+         */
+        static std::shared_mutex classCacheMutex;
+
     private:
 
         /**
@@ -78,6 +106,12 @@ namespace easyjni {
 
     public:
 
+        /**
+         * The maximum number of local references created while filling an array of
+         * objects before these references are released.
+         */
+        static constexpr int LOCAL_FRAME_CAPACITY = 256;
+
         /**
          * Forbids the copy of an instance of Java Virtual Machine.
          */
@@ -109,6 +143,12 @@ namespace easyjni {
 
         /**
          * Loads a class from this Java Virtual Machine.
+         * Loaded classes are cached, so that loading the same class again gives
+         * the same global reference without looking up the class.
+         * The returned class always holds a global reference.
+         * Once the cache is full, a cached class is evicted to make room for the
+         * loaded one: as for invalidateClass(), its global reference is retired
+         * until reclaimInvalidatedClasses() is called.
          *
          * @param name The name of the class to load.
          *
@@ -118,8 +158,58 @@ namespace easyjni {
          */
         easyjni::JavaClass loadClass(const std::string &name);
 
+        /**
+         * Removes a class from the class cache, together with the members of this
+         * class stored in the member cache.
+         * The global reference of the class is retired rather than deleted, so that
+         * the JavaClass instances previously obtained for this class remain valid.
+         *
+         * @param name The name of the class to remove from the cache.
+         *
+         * @see #reclaimInvalidatedClasses()
+         */
+        void invalidateClass(const std::string &name);
+
+        /**
+         * Removes all classes from the class cache, together with all the members
+         * stored in the member cache.
+         * The global references of the classes are retired rather than deleted, so
+         * that the JavaClass instances previously obtained from loadClass() remain
+         * valid.
+         *
+         * @see #reclaimInvalidatedClasses()
+         */
+        void invalidateClassCache();
+
+        /**
+         * Deletes the global references of the classes that have been removed from
+         * the class cache, so that these classes may be unloaded.
+         * This is done automatically when the Java Virtual Machine is destroyed.
+         * The JavaClass instances obtained for these classes before their
+         * invalidation must not be used anymore.
+         */
+        void reclaimInvalidatedClasses();
+
+        /**
+         * Gives the number of classes that are currently stored in the class cache.
+         *
+         * @return The number of cached classes.
+         */
+        static std::size_t getClassCacheSize();
+
+        /**
+         * Sets the maximum number of classes that can be stored in the class cache.
+         * The classes that are already cached are kept, and are evicted as other
+         * classes are loaded.
+         *
+         * @param capacity The maximum number of classes to cache.
+         */
+        static void setClassCacheCapacity(std::size_t capacity);
+
         /**
          * Wraps a boolean value into an object.
+         * As in Java, the objects wrapping small values are cached, and a new local
+         * reference to the same object is returned each time such a value is wrapped.
          *
          * @param b The value to wrap.
          *
@@ -131,6 +221,8 @@ namespace easyjni {
 
         /**
          * Wraps a byte value into an object.
+         * As in Java, the objects wrapping small values are cached, and a new local
+         * reference to the same object is returned each time such a value is wrapped.
          *
          * @param b The value to wrap.
          *
@@ -142,6 +234,8 @@ namespace easyjni {
 
         /**
          * Wraps a char value into an object.
+         * As in Java, the objects wrapping small values are cached, and a new local
+         * reference to the same object is returned each time such a value is wrapped.
          *
          * @param c The value to wrap.
          *
@@ -153,6 +247,8 @@ namespace easyjni {
 
         /**
          * Wraps a short value into an object.
+         * As in Java, the objects wrapping small values are cached, and a new local
+         * reference to the same object is returned each time such a value is wrapped.
          *
          * @param s The value to wrap.
          *
@@ -164,6 +260,8 @@ namespace easyjni {
 
         /**
          * Wraps an int value into an object.
+         * As in Java, the objects wrapping small values are cached, and a new local
+         * reference to the same object is returned each time such a value is wrapped.
          *
          * @param i The value to wrap.
          *
@@ -175,6 +273,8 @@ namespace easyjni {
 
         /**
          * Wraps a long value into an object.
+         * As in Java, the objects wrapping small values are cached, and a new local
+         * reference to the same object is returned each time such a value is wrapped.
          *
          * @param l The value to wrap.
          *
@@ -327,6 +427,18 @@ namespace easyjni {
          */
         easyjni::JavaArray<jboolean> createBooleanArray(int size);
 
+        /**
+         * Creates an array of boolean values in the Java Virtual Machine, containing
+         * the given elements.
+         *
+         * @param elements The elements of the array.
+         *
+         * @return The created array.
+         *
+         * @throws JniException If an error occurred while creating the array.
+         */
+        easyjni::JavaArray<jboolean> createBooleanArray(std::span<const jboolean> elements);
+
         /**
          * Creates an array of byte values in the Java Virtual Machine.
          *
@@ -338,6 +450,18 @@ namespace easyjni {
          */
         easyjni::JavaArray<jbyte> createByteArray(int size);
 
+        /**
+         * Creates an array of byte values in the Java Virtual Machine, containing
+         * the given elements.
+         *
+         * @param elements The elements of the array.
+         *
+         * @return The created array.
+         *
+         * @throws JniException If an error occurred while creating the array.
+         */
+        easyjni::JavaArray<jbyte> createByteArray(std::span<const jbyte> elements);
+
         /**
          * Creates an array of char values in the Java Virtual Machine.
          *
@@ -349,6 +473,18 @@ namespace easyjni {
          */
         easyjni::JavaArray<jchar> createCharArray(int size);
 
+        /**
+         * Creates an array of char values in the Java Virtual Machine, containing
+         * the given elements.
+         *
+         * @param elements The elements of the array.
+         *
+         * @return The created array.
+         *
+         * @throws JniException If an error occurred while creating the array.
+         */
+        easyjni::JavaArray<jchar> createCharArray(std::span<const jchar> elements);
+
         /**
          * Creates an array of short values in the Java Virtual Machine.
          *
@@ -360,6 +496,18 @@ namespace easyjni {
          */
         easyjni::JavaArray<jshort> createShortArray(int size);
 
+        /**
+         * Creates an array of short values in the Java Virtual Machine, containing
+         * the given elements.
+         *
+         * @param elements The elements of the array.
+         *
+         * @return The created array.
+         *
+         * @throws JniException If an error occurred while creating the array.
+         */
+        easyjni::JavaArray<jshort> createShortArray(std::span<const jshort> elements);
+
         /**
          * Creates an array of int values in the Java Virtual Machine.
          *
@@ -371,6 +519,18 @@ namespace easyjni {
          */
         easyjni::JavaArray<jint> createIntArray(int size);
 
+        /**
+         * Creates an array of int values in the Java Virtual Machine, containing
+         * the given elements.
+         *
+         * @param elements The elements of the array.
+         *
+         * @return The created array.
+         *
+         * @throws JniException If an error occurred while creating the array.
+         */
+        easyjni::JavaArray<jint> createIntArray(std::span<const jint> elements);
+
         /**
          * Creates an array of long values in the Java Virtual Machine.
          *
@@ -382,6 +542,18 @@ namespace easyjni {
          */
         easyjni::JavaArray<jlong> createLongArray(int size);
 
+        /**
+         * Creates an array of long values in the Java Virtual Machine, containing
+         * the given elements.
+         *
+         * @param elements The elements of the array.
+         *
+         * @return The created array.
+         *
+         * @throws JniException If an error occurred while creating the array.
+         */
+        easyjni::JavaArray<jlong> createLongArray(std::span<const jlong> elements);
+
         /**
          * Creates an array of float values in the Java Virtual Machine.
          *
@@ -393,6 +565,18 @@ namespace easyjni {
          */
         easyjni::JavaArray<jfloat> createFloatArray(int size);
 
+        /**
+         * Creates an array of float values in the Java Virtual Machine, containing
+         * the given elements.
+         *
+         * @param elements The elements of the array.
+         *
+         * @return The created array.
+         *
+         * @throws JniException If an error occurred while creating the array.
+         */
+        easyjni::JavaArray<jfloat> createFloatArray(std::span<const jfloat> elements);
+
         /**
          * Creates an array of double values in the Java Virtual Machine.
          *
@@ -404,6 +588,18 @@ namespace easyjni {
          */
         easyjni::JavaArray<jdouble> createDoubleArray(int size);
 
+        /**
+         * Creates an array of double values in the Java Virtual Machine, containing
+         * the given elements.
+         *
+         * @param elements The elements of the array.
+         *
+         * @return The created array.
+         *
+         * @throws JniException If an error occurred while creating the array.
+         */
+        easyjni::JavaArray<jdouble> createDoubleArray(std::span<const jdouble> elements);
+
         /**
          * Creates an array of objects in the Java Virtual Machine.
          *
@@ -415,6 +611,81 @@ namespace easyjni {
          */
         easyjni::JavaArray<easyjni::JavaObject> createObjectArray(int size, const easyjni::JavaClass &clazz);
 
+        /**
+         * Creates an array of objects in the Java Virtual Machine, containing the
+         * given elements.
+         *
+         * @param elements The elements of the array.
+         * @param clazz The class of the elements of the array.
+         *
+         * @return The created array.
+         *
+         * @throws JniException If an error occurred while creating the array.
+         */
+        easyjni::JavaArray<easyjni::JavaObject> createObjectArray(
+                std::span<const easyjni::JavaObject> elements, const easyjni::JavaClass &clazz);
+
+        /**
+         * Creates an array of objects in the Java Virtual Machine, containing the
+         * objects obtained by converting the elements of the given range.
+         * The objects are converted within local frames holding at most
+         * LOCAL_FRAME_CAPACITY references, so that the number of local references
+         * does not grow with the size of the range.
+         *
+         * @tparam Range The type of the range of elements to convert.
+         * @tparam Converter The type of the function converting an element into a JavaObject.
+         *
+         * @param elements The elements to convert.
+         * @param clazz The class of the elements of the array.
+         * @param converter The function converting an element into a JavaObject.
+         *
+         * @return The created array, as a JavaArray<JavaObject>.
+         *
+         * @throws JniException If an error occurred while creating the array or
+         *         converting its elements.
+         */
+        template<std::ranges::sized_range Range, typename Converter>
+        auto createObjectArray(Range &&elements, const easyjni::JavaClass &clazz, Converter converter) {
+            // The return type is deduced, as JavaArray may not be complete yet.
+            auto it = std::ranges::begin(elements);
+            return createObjectArray(static_cast<int>(std::ranges::size(elements)), clazz,
+                                     std::function<easyjni::JavaObject()>([&]() {
+                                         return converter(*it++);
+                                     }));
+        }
+
+        /**
+         * Creates an array of strings in the Java Virtual Machine, containing
+         * the given strings.
+         *
+         * @param elements The strings to put in the array.
+         *
+         * @return The created array.
+         *
+         * @throws JniException If an error occurred while creating the array.
+         */
+        easyjni::JavaArray<easyjni::JavaObject> createStringArray(std::span<const std::string> elements);
+
+    private:
+
+        /**
+         * Creates an array of objects in the Java Virtual Machine, and fills it with
+         * the objects produced by the given function.
+         * These objects are produced within local frames holding at most
+         * LOCAL_FRAME_CAPACITY references.
+         *
+         * @param size The size of the array.
+         * @param clazz The class of the elements of the array.
+         * @param next The function producing the next element of the array.
+         *
+         * @return The created array.
+         *
+         * @throws JniException If an error occurred while creating the array or
+         *         producing its elements.
+         */
+        easyjni::JavaArray<easyjni::JavaObject> createObjectArray(
+                int size, const easyjni::JavaClass &clazz, const std::function<easyjni::JavaObject()> &next);
+
         /**
          * The JavaVirtualMachineBuilder is a friend class, which allows
          * to build instances of JavaVirtualMachine.
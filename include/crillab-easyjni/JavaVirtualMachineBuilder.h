@@ -111,6 +111,18 @@ namespace easyjni {
 
     private:
 
+        /**
+         * Defines the Java classes that are embedded in EasyJNI, such as the
+         * class used by JavaBulkDispatcher.
+         *
+         * @param jvm The Java Virtual Machine that has just been created.
+         * @param env The environment of the Java Virtual Machine.
+         *
+         * @throws JniException If the classes could not be defined, in which case
+         *         the Java Virtual Machine is destroyed.
+         */
+        static void defineEmbeddedClasses(JavaVM *jvm, JNIEnv *env);
+
         /**
          * Builds the classpath string to use as option to the Java Virtual Machine.
          *
@@ -21,14 +21,42 @@
 #ifndef EASYJNI_JAVAVIRTUALMACHINEREGISTRY_H
 #define EASYJNI_JAVAVIRTUALMACHINEREGISTRY_H
 
+#include <atomic>
 #include <map>
 #include <mutex>
+#include <string>
 #include <thread>
 
+#include "JavaContext.h"
 #include "JavaVirtualMachine.h"
 
 namespace easyjni {
 
+    /**
+     * The AttachPolicy defines how the threads are attached to the Java Virtual
+     * Machine when they first access it.
+     */
+    enum class AttachPolicy {
+
+        /**
+         * Threads are attached as normal (non-daemon) Java threads.
+         */
+        NORMAL,
+
+        /**
+         * Threads are attached as daemon Java threads, which do not prevent the
+         * Java Virtual Machine from shutting down.
+         */
+        DAEMON,
+
+        /**
+         * Threads are attached as normal Java threads, with a name made of a
+         * user-defined prefix followed by a unique number.
+         */
+        NAMED
+
+    };
+
     /**
      * The JavaVirtualMachineRegistry allows to make instances of the Java
      * Virtual Machine globally accessible.
@@ -56,6 +84,59 @@ namespace easyjni {
          */
         static std::mutex mutex;
 
+        /**
+         * The generation of the registry, which is incremented each time the main
+         * Java Virtual Machine is cleared, so as to invalidate the Java Virtual
+         * Machines cached by the different threads.
+         */
+        static std::atomic<unsigned long> generation;
+
+        /**
+         * The policy used to attach threads to the Java Virtual Machine.
+         */
+        static easyjni::AttachPolicy attachPolicy;
+
+        /**
+         * The prefix of the name given to the threads attached with the NAMED policy.
+         */
+        static std::string threadNamePrefix;
+
+        /**
+         * The number of threads that have been attached with the NAMED policy.
+         */
+        static unsigned long nbNamedThreads;
+
+        /**
+         * The ThreadAttachment caches the Java Virtual Machine to which a thread
+         * is attached, and detaches this thread when it exits.
+         */
+        struct ThreadAttachment {
+
+            /**
+             * The Java Virtual Machine to which the thread is attached, cached so
+             * that it can be retrieved without taking the mutex.
+             */
+            easyjni::JavaVirtualMachine *jvm = nullptr;
+
+            /**
+             * The generation of the registry at the time the Java Virtual Machine
+             * has been cached.
+             */
+            unsigned long generation = 0;
+
+            /**
+             * Detaches the thread from the Java Virtual Machine (if it is still
+             * attached to it) when the thread exits, and releases its record.
+             */
+            ~ThreadAttachment();
+
+        };
+
+        /**
+         * The attachment of the current thread.
+         */
+        static thread_local ThreadAttachment current;
+
     public:
 
         /**
@@ -88,8 +169,35 @@ namespace easyjni {
          */
         static JNIEnv *getEnvironment();
 
+        /**
+         * Sets the policy used to attach the threads to the Java Virtual Machine
+         * when they first access it.
+         * Threads that are already attached are not affected.
+         *
+         * @param policy The policy to use.
+         * @param namePrefix The prefix of the name given to the threads attached with
+         *        the NAMED policy.
+         */
+        static void setAttachPolicy(AttachPolicy policy, const std::string &namePrefix = "easyjni-thread");
+
+        /**
+         * Gives a context wrapping the environment of the Java Virtual Machine attached
+         * to the current thread.
+         * This context may then be reused by the current thread to perform calls without
+         * looking up its environment again.
+         *
+         * @param policy The policy used by the context to check exceptions.
+         *
+         * @return The context of the current thread.
+         *
+         * @throws JniException If no Java Virtual Machine has been registered yet.
+         */
+        static JavaContext getContext(
+                JavaContext::ExceptionPolicy policy = JavaContext::ExceptionPolicy::IMMEDIATE);
+
         /**
          * Detaches the current thread from the Java Virtual Machine.
+         * Note that threads are also automatically detached when they exit.
          *
          * @throws JniException If the current thread is the main thread.
          */
@@ -100,6 +208,26 @@ namespace easyjni {
          */
         static void clear();
 
+    private:
+
+        /**
+         * Gives the instance of Java Virtual Machine attached to the current thread,
+         * attaching this thread if needed.
+         * This method is only called when the thread-local cache is empty or outdated.
+         *
+         * @return The instance of Java Virtual Machine, or nullptr if no Java Virtual Machine
+         *         has been registered yet.
+         */
+        static JavaVirtualMachine *attachCurrentThread();
+
+        /**
+         * Caches the Java Virtual Machine to which the current thread is attached.
+         * This method must be called while holding the mutex.
+         *
+         * @param jvm The Java Virtual Machine to cache.
+         */
+        static void cacheCurrentJvm(JavaVirtualMachine *jvm);
+
     };
 
 }
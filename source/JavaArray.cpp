@@ -25,126 +25,222 @@ using namespace easyjni;
 using namespace std;
 
 template<>
-jboolean JavaArray<jboolean>::get(int index) {
+jboolean JavaArray<jboolean>::get(const JavaContext &context, int index) {
     jboolean b;
-    JavaVirtualMachineRegistry::getEnvironment()->GetBooleanArrayRegion((jbooleanArray) array, index, 1, &b);
-    JavaVirtualMachineRegistry::get()->checkException();
+    context.getEnvironment()->GetBooleanArrayRegion((jbooleanArray) array, index, 1, &b);
+    context.afterCall();
     return b;
 }
 
 template<>
-void JavaArray<jboolean>::set(int index, jboolean elt) {
-    JavaVirtualMachineRegistry::getEnvironment()->SetBooleanArrayRegion((jbooleanArray) array, index, 1, &elt);
-    JavaVirtualMachineRegistry::get()->checkException();
+void JavaArray<jboolean>::set(const JavaContext &context, int index, jboolean elt) {
+    context.getEnvironment()->SetBooleanArrayRegion((jbooleanArray) array, index, 1, &elt);
+    context.afterCall();
 }
 
 template<>
-jbyte JavaArray<jbyte>::get(int index) {
+void JavaArray<jboolean>::getRegion(const JavaContext &context, int offset, span<jboolean> elements) {
+    context.getEnvironment()->GetBooleanArrayRegion((jbooleanArray) array, offset, (jsize) elements.size(), elements.data());
+    context.afterCall();
+}
+
+template<>
+void JavaArray<jboolean>::setRegion(const JavaContext &context, int offset, span<const jboolean> elements) {
+    context.getEnvironment()->SetBooleanArrayRegion((jbooleanArray) array, offset, (jsize) elements.size(), elements.data());
+    context.afterCall();
+}
+
+template<>
+jbyte JavaArray<jbyte>::get(const JavaContext &context, int index) {
     jbyte b;
-    JavaVirtualMachineRegistry::getEnvironment()->GetByteArrayRegion((jbyteArray) array, index, 1, &b);
-    JavaVirtualMachineRegistry::get()->checkException();
+    context.getEnvironment()->GetByteArrayRegion((jbyteArray) array, index, 1, &b);
+    context.afterCall();
     return b;
 }
 
 template<>
-void JavaArray<jbyte>::set(int index, jbyte elt) {
-    JavaVirtualMachineRegistry::getEnvironment()->SetByteArrayRegion((jbyteArray) array, index, 1, &elt);
-    JavaVirtualMachineRegistry::get()->checkException();
+void JavaArray<jbyte>::set(const JavaContext &context, int index, jbyte elt) {
+    context.getEnvironment()->SetByteArrayRegion((jbyteArray) array, index, 1, &elt);
+    context.afterCall();
+}
+
+template<>
+void JavaArray<jbyte>::getRegion(const JavaContext &context, int offset, span<jbyte> elements) {
+    context.getEnvironment()->GetByteArrayRegion((jbyteArray) array, offset, (jsize) elements.size(), elements.data());
+    context.afterCall();
+}
+
+template<>
+void JavaArray<jbyte>::setRegion(const JavaContext &context, int offset, span<const jbyte> elements) {
+    context.getEnvironment()->SetByteArrayRegion((jbyteArray) array, offset, (jsize) elements.size(), elements.data());
+    context.afterCall();
 }
 
 template<>
-jchar JavaArray<jchar>::get(int index) {
+jchar JavaArray<jchar>::get(const JavaContext &context, int index) {
     jchar c;
-    JavaVirtualMachineRegistry::getEnvironment()->GetCharArrayRegion((jcharArray) array, index, 1, &c);
-    JavaVirtualMachineRegistry::get()->checkException();
+    context.getEnvironment()->GetCharArrayRegion((jcharArray) array, index, 1, &c);
+    context.afterCall();
     return c;
 }
 
 template<>
-void JavaArray<jchar>::set(int index, jchar elt) {
-    JavaVirtualMachineRegistry::getEnvironment()->SetCharArrayRegion((jcharArray) array, index, 1, &elt);
-    JavaVirtualMachineRegistry::get()->checkException();
+void JavaArray<jchar>::set(const JavaContext &context, int index, jchar elt) {
+    context.getEnvironment()->SetCharArrayRegion((jcharArray) array, index, 1, &elt);
+    context.afterCall();
 }
 
 template<>
-jshort JavaArray<jshort>::get(int index) {
+void JavaArray<jchar>::getRegion(const JavaContext &context, int offset, span<jchar> elements) {
+    context.getEnvironment()->GetCharArrayRegion((jcharArray) array, offset, (jsize) elements.size(), elements.data());
+    context.afterCall();
+}
+
+template<>
+void JavaArray<jchar>::setRegion(const JavaContext &context, int offset, span<const jchar> elements) {
+    context.getEnvironment()->SetCharArrayRegion((jcharArray) array, offset, (jsize) elements.size(), elements.data());
+    context.afterCall();
+}
+
+template<>
+jshort JavaArray<jshort>::get(const JavaContext &context, int index) {
     jshort s;
-    JavaVirtualMachineRegistry::getEnvironment()->GetShortArrayRegion((jshortArray) array, index, 1, &s);
-    JavaVirtualMachineRegistry::get()->checkException();
+    context.getEnvironment()->GetShortArrayRegion((jshortArray) array, index, 1, &s);
+    context.afterCall();
     return s;
 }
 
 template<>
-void JavaArray<jshort>::set(int index, jshort elt) {
-    JavaVirtualMachineRegistry::getEnvironment()->SetShortArrayRegion((jshortArray) array, index, 1, &elt);
-    JavaVirtualMachineRegistry::get()->checkException();
+void JavaArray<jshort>::set(const JavaContext &context, int index, jshort elt) {
+    context.getEnvironment()->SetShortArrayRegion((jshortArray) array, index, 1, &elt);
+    context.afterCall();
+}
+
+template<>
+void JavaArray<jshort>::getRegion(const JavaContext &context, int offset, span<jshort> elements) {
+    context.getEnvironment()->GetShortArrayRegion((jshortArray) array, offset, (jsize) elements.size(), elements.data());
+    context.afterCall();
+}
+
+template<>
+void JavaArray<jshort>::setRegion(const JavaContext &context, int offset, span<const jshort> elements) {
+    context.getEnvironment()->SetShortArrayRegion((jshortArray) array, offset, (jsize) elements.size(), elements.data());
+    context.afterCall();
 }
 
 template<>
-jint JavaArray<jint>::get(int index) {
+jint JavaArray<jint>::get(const JavaContext &context, int index) {
     jint i;
-    JavaVirtualMachineRegistry::getEnvironment()->GetIntArrayRegion((jintArray) array, index, 1, &i);
-    JavaVirtualMachineRegistry::get()->checkException();
+    context.getEnvironment()->GetIntArrayRegion((jintArray) array, index, 1, &i);
+    context.afterCall();
     return i;
 }
 
 template<>
-void JavaArray<jint>::set(int index, jint elt) {
-    JavaVirtualMachineRegistry::getEnvironment()->SetIntArrayRegion((jintArray) array, index, 1, &elt);
-    JavaVirtualMachineRegistry::get()->checkException();
+void JavaArray<jint>::set(const JavaContext &context, int index, jint elt) {
+    context.getEnvironment()->SetIntArrayRegion((jintArray) array, index, 1, &elt);
+    context.afterCall();
 }
 
 template<>
-jlong JavaArray<jlong>::get(int index) {
+void JavaArray<jint>::getRegion(const JavaContext &context, int offset, span<jint> elements) {
+    context.getEnvironment()->GetIntArrayRegion((jintArray) array, offset, (jsize) elements.size(), elements.data());
+    context.afterCall();
+}
+
+template<>
+void JavaArray<jint>::setRegion(const JavaContext &context, int offset, span<const jint> elements) {
+    context.getEnvironment()->SetIntArrayRegion((jintArray) array, offset, (jsize) elements.size(), elements.data());
+    context.afterCall();
+}
+
+template<>
+jlong JavaArray<jlong>::get(const JavaContext &context, int index) {
     jlong l;
-    JavaVirtualMachineRegistry::getEnvironment()->GetLongArrayRegion((jlongArray) array, index, 1, &l);
-    JavaVirtualMachineRegistry::get()->checkException();
+    context.getEnvironment()->GetLongArrayRegion((jlongArray) array, index, 1, &l);
+    context.afterCall();
     return l;
 }
 
 template<>
-void JavaArray<jlong>::set(int index, jlong elt) {
-    JavaVirtualMachineRegistry::getEnvironment()->SetLongArrayRegion((jlongArray) array, index, 1, &elt);
-    JavaVirtualMachineRegistry::get()->checkException();
+void JavaArray<jlong>::set(const JavaContext &context, int index, jlong elt) {
+    context.getEnvironment()->SetLongArrayRegion((jlongArray) array, index, 1, &elt);
+    context.afterCall();
+}
+
+template<>
+void JavaArray<jlong>::getRegion(const JavaContext &context, int offset, span<jlong> elements) {
+    context.getEnvironment()->GetLongArrayRegion((jlongArray) array, offset, (jsize) elements.size(), elements.data());
+    context.afterCall();
+}
+
+template<>
+void JavaArray<jlong>::setRegion(const JavaContext &context, int offset, span<const jlong> elements) {
+    context.getEnvironment()->SetLongArrayRegion((jlongArray) array, offset, (jsize) elements.size(), elements.data());
+    context.afterCall();
 }
 
 template<>
-jfloat JavaArray<jfloat>::get(int index) {
+jfloat JavaArray<jfloat>::get(const JavaContext &context, int index) {
     jfloat f;
-    JavaVirtualMachineRegistry::getEnvironment()->GetFloatArrayRegion((jfloatArray) array, index, 1, &f);
-    JavaVirtualMachineRegistry::get()->checkException();
+    context.getEnvironment()->GetFloatArrayRegion((jfloatArray) array, index, 1, &f);
+    context.afterCall();
     return f;
 }
 
 template<>
-void JavaArray<jfloat>::set(int index, jfloat elt) {
-    JavaVirtualMachineRegistry::getEnvironment()->SetFloatArrayRegion((jfloatArray) array, index, 1, &elt);
-    JavaVirtualMachineRegistry::get()->checkException();
+void JavaArray<jfloat>::set(const JavaContext &context, int index, jfloat elt) {
+    context.getEnvironment()->SetFloatArrayRegion((jfloatArray) array, index, 1, &elt);
+    context.afterCall();
 }
 
 template<>
-jdouble JavaArray<jdouble>::get(int index) {
+void JavaArray<jfloat>::getRegion(const JavaContext &context, int offset, span<jfloat> elements) {
+    context.getEnvironment()->GetFloatArrayRegion((jfloatArray) array, offset, (jsize) elements.size(), elements.data());
+    context.afterCall();
+}
+
+template<>
+void JavaArray<jfloat>::setRegion(const JavaContext &context, int offset, span<const jfloat> elements) {
+    context.getEnvironment()->SetFloatArrayRegion((jfloatArray) array, offset, (jsize) elements.size(), elements.data());
+    context.afterCall();
+}
+
+template<>
+jdouble JavaArray<jdouble>::get(const JavaContext &context, int index) {
     jdouble d;
-    JavaVirtualMachineRegistry::getEnvironment()->GetDoubleArrayRegion((jdoubleArray) array, index, 1, &d);
-    JavaVirtualMachineRegistry::get()->checkException();
+    context.getEnvironment()->GetDoubleArrayRegion((jdoubleArray) array, index, 1, &d);
+    context.afterCall();
     return d;
 }
 
 template<>
-void JavaArray<jdouble>::set(int index, jdouble elt) {
-    JavaVirtualMachineRegistry::getEnvironment()->SetDoubleArrayRegion((jdoubleArray) array, index, 1, &elt);
-    JavaVirtualMachineRegistry::get()->checkException();
+void JavaArray<jdouble>::set(const JavaContext &context, int index, jdouble elt) {
+    context.getEnvironment()->SetDoubleArrayRegion((jdoubleArray) array, index, 1, &elt);
+    context.afterCall();
+}
+
+template<>
+void JavaArray<jdouble>::getRegion(const JavaContext &context, int offset, span<jdouble> elements) {
+    context.getEnvironment()->GetDoubleArrayRegion((jdoubleArray) array, offset, (jsize) elements.size(), elements.data());
+    context.afterCall();
+}
+
+template<>
+void JavaArray<jdouble>::setRegion(const JavaContext &context, int offset, span<const jdouble> elements) {
+    context.getEnvironment()->SetDoubleArrayRegion((jdoubleArray) array, offset, (jsize) elements.size(), elements.data());
+    context.afterCall();
 }
 
 template<>
-JavaObject JavaArray<JavaObject>::get(int index) {
-    jobject obj = JavaVirtualMachineRegistry::getEnvironment()->GetObjectArrayElement((jobjectArray) array, index);
-    JavaVirtualMachineRegistry::get()->checkException();
+JavaObject JavaArray<JavaObject>::get(const JavaContext &context, int index) {
+    jobject obj = context.getEnvironment()->GetObjectArrayElement((jobjectArray) array, index);
+    context.afterCall();
     return JavaObject(obj);
 }
 
 template<>
-void JavaArray<JavaObject>::set(int index, JavaObject elt) {
-    JavaVirtualMachineRegistry::getEnvironment()->SetObjectArrayElement((jobjectArray) array, index, *elt);
-    JavaVirtualMachineRegistry::get()->checkException();
+void JavaArray<JavaObject>::set(const JavaContext &context, int index, JavaObject elt) {
+    context.getEnvironment()->SetObjectArrayElement((jobjectArray) array, index, *elt);
+    context.afterCall();
 }
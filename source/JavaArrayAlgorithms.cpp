@@ -0,0 +1,193 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "crillab-easyjni/JavaArrayAlgorithms.h"
+
+using namespace easyjni;
+using namespace std;
+
+/**
+ * The JavaOrder compares values as java.util.Arrays does, which defines a total
+ * order even on floating point values.
+ *
+ * @tparam T The type of the values to compare.
+ */
+template<typename T>
+struct JavaOrder {
+
+    /**
+     * Checks whether a value comes before another one.
+     *
+     * @param a The first value.
+     * @param b The second value.
+     *
+     * @return Whether a comes before b.
+     */
+    bool operator()(T a, T b) const {
+        if constexpr (is_floating_point_v<T>) {
+            if (a < b) {
+                return true;
+            }
+            if ((a > b) || isnan(a)) {
+                return false;
+            }
+            if (isnan(b)) {
+                return true;
+            }
+            // The values are equal, but -0.0 comes before 0.0.
+            return signbit(a) && !signbit(b);
+
+        } else {
+            return a < b;
+        }
+    }
+
+};
+
+/**
+ * Sorts the given values, in parallel if there are enough of them.
+ * The values are split into chunks that are sorted by different threads, and
+ * the sorted chunks are then merged pairwise (also in parallel).
+ * Merging is stable, so that the sort is stable if the chunks are sorted stably.
+ *
+ * @tparam T The type of the values.
+ * @tparam Sorter The type of the function sorting a chunk.
+ *
+ * @param values The values to sort.
+ * @param nbThreads The maximum number of threads to use, or 0 to use as many
+ *        threads as there are hardware threads.
+ * @param sorter The function sorting a chunk.
+ */
+template<typename T, typename Sorter>
+static void parallelSort(span<T> values, unsigned nbThreads, Sorter sorter) {
+    if (nbThreads == 0) {
+        nbThreads = max(1U, thread::hardware_concurrency());
+    }
+    size_t size = values.size();
+    size_t nbChunks = min<size_t>(nbThreads, size / (JavaArrayAlgorithms::PARALLEL_THRESHOLD / 2));
+    if (nbChunks <= 1) {
+        sorter(values.begin(), values.end());
+        return;
+    }
+
+    // Sorting each chunk in its own thread.
+    vector<size_t> bounds(nbChunks + 1);
+    for (size_t i = 0; i <= nbChunks; i++) {
+        bounds[i] = size * i / nbChunks;
+    }
+    {
+        vector<jthread> threads;
+        for (size_t i = 0; i < nbChunks; i++) {
+            threads.emplace_back([&, i] {
+                sorter(values.begin() + static_cast<ptrdiff_t>(bounds[i]),
+                       values.begin() + static_cast<ptrdiff_t>(bounds[i + 1]));
+            });
+        }
+    }
+
+    // Merging the sorted chunks pairwise, until there is only one chunk left.
+    vector<T> buffer(size);
+    T *source = values.data();
+    T *destination = buffer.data();
+    while (bounds.size() > 2) {
+        vector<size_t> next;
+        {
+            vector<jthread> threads;
+            size_t i = 0;
+            for (; i + 2 < bounds.size(); i += 2) {
+                threads.emplace_back([=, &bounds] {
+                    merge(source + bounds[i], source + bounds[i + 1],
+                          source + bounds[i + 1], source + bounds[i + 2],
+                          destination + bounds[i], JavaOrder<T>());
+                });
+                next.push_back(bounds[i]);
+            }
+            if (i + 1 < bounds.size()) {
+                // The last chunk has no chunk to be merged with.
+                copy(source + bounds[i], source + bounds[i + 1], destination + bounds[i]);
+                next.push_back(bounds[i]);
+            }
+        }
+        next.push_back(size);
+        bounds = std::move(next);
+        swap(source, destination);
+    }
+
+    if (source != values.data()) {
+        copy(source, source + size, values.data());
+    }
+}
+
+template<typename T>
+void JavaArrayAlgorithms::sort(span<T> values, unsigned nbThreads) {
+    parallelSort(values, nbThreads, [](auto first, auto last) {
+        std::sort(first, last, JavaOrder<T>());
+    });
+}
+
+template<typename T>
+void JavaArrayAlgorithms::stableSort(span<T> values, unsigned nbThreads) {
+    parallelSort(values, nbThreads, [](auto first, auto last) {
+        std::stable_sort(first, last, JavaOrder<T>());
+    });
+}
+
+template<typename T>
+void JavaArrayAlgorithms::nthElement(span<T> values, size_t n) {
+    if (n < values.size()) {
+        std::nth_element(values.begin(), values.begin() + static_cast<ptrdiff_t>(n), values.end(), JavaOrder<T>());
+    }
+}
+
+template<typename T>
+ptrdiff_t JavaArrayAlgorithms::binarySearch(span<const T> values, T key) {
+    JavaOrder<T> order;
+    auto it = lower_bound(values.begin(), values.end(), key, order);
+    auto index = static_cast<ptrdiff_t>(it - values.begin());
+    if ((it != values.end()) && !order(key, *it)) {
+        return index;
+    }
+    return -index - 1;
+}
+
+/**
+ * Instantiates the algorithms for a primitive type.
+ *
+ * @param T The primitive type.
+ */
+#define INSTANTIATE_ALGORITHMS(T)                                                     \
+    template void JavaArrayAlgorithms::sort<T>(span<T>, unsigned);                    \
+    template void JavaArrayAlgorithms::stableSort<T>(span<T>, unsigned);              \
+    template void JavaArrayAlgorithms::nthElement<T>(span<T>, size_t);                \
+    template ptrdiff_t JavaArrayAlgorithms::binarySearch<T>(span<const T>, T);
+
+INSTANTIATE_ALGORITHMS(jbyte)
+INSTANTIATE_ALGORITHMS(jchar)
+INSTANTIATE_ALGORITHMS(jshort)
+INSTANTIATE_ALGORITHMS(jint)
+INSTANTIATE_ALGORITHMS(jlong)
+INSTANTIATE_ALGORITHMS(jfloat)
+INSTANTIATE_ALGORITHMS(jdouble)
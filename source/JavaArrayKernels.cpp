@@ -0,0 +1,644 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "crillab-easyjni/JavaArrayKernels.h"
+#include "crillab-easyjni/JniException.h"
+
+using namespace easyjni;
+using namespace std;
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define EASYJNI_MULTIVERSIONING
+#define EASYJNI_ALWAYS_INLINE inline __attribute__((always_inline))
+#define EASYJNI_TARGET(isa) __attribute__((target(isa)))
+#else
+#define EASYJNI_ALWAYS_INLINE inline
+#endif
+
+/**
+ * The number of independent lanes used by the kernels to accumulate values,
+ * which allows the compiler to vectorize them without reassociating floating
+ * point operations.
+ */
+static constexpr size_t LANES = 16;
+
+/**
+ * The InstructionSet enumerates the instruction sets to which the kernels may
+ * be dispatched.
+ */
+enum class InstructionSet {
+    SCALAR,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+/**
+ * Detects the best instruction set supported by the processor.
+ *
+ * @return The detected instruction set.
+ */
+static InstructionSet detectInstructionSet() {
+#ifdef EASYJNI_MULTIVERSIONING
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        return InstructionSet::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return InstructionSet::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return InstructionSet::SSE2;
+    }
+#endif
+    return InstructionSet::SCALAR;
+}
+
+/**
+ * The instruction set used by the kernels.
+ */
+static const InstructionSet instructionSet = detectInstructionSet();
+
+/**
+ * Adds two values, wrapping around on overflow for integers (as Java does).
+ *
+ * @tparam R The type of the values.
+ *
+ * @param a The first value.
+ * @param b The second value.
+ *
+ * @return The sum of the values.
+ */
+template<typename R>
+static EASYJNI_ALWAYS_INLINE R add(R a, R b) {
+    if constexpr (is_integral_v<R>) {
+        return static_cast<R>(static_cast<make_unsigned_t<R>>(a) + static_cast<make_unsigned_t<R>>(b));
+    } else {
+        return a + b;
+    }
+}
+
+/**
+ * Multiplies two values, wrapping around on overflow for integers (as Java does).
+ *
+ * @tparam R The type of the values.
+ *
+ * @param a The first value.
+ * @param b The second value.
+ *
+ * @return The product of the values.
+ */
+template<typename R>
+static EASYJNI_ALWAYS_INLINE R multiply(R a, R b) {
+    if constexpr (is_integral_v<R>) {
+        return static_cast<R>(static_cast<make_unsigned_t<R>>(a) * static_cast<make_unsigned_t<R>>(b));
+    } else {
+        return a * b;
+    }
+}
+
+/**
+ * Computes the sum of the given values.
+ */
+template<typename T, typename R>
+static EASYJNI_ALWAYS_INLINE R sumKernel(const T *values, size_t size) {
+    R lanes[LANES] = {};
+    size_t i = 0;
+    for (; i + LANES <= size; i += LANES) {
+        for (size_t l = 0; l < LANES; l++) {
+            lanes[l] = add(lanes[l], static_cast<R>(values[i + l]));
+        }
+    }
+
+    R result = 0;
+    for (; i < size; i++) {
+        result = add(result, static_cast<R>(values[i]));
+    }
+    for (auto lane : lanes) {
+        result = add(result, lane);
+    }
+    return result;
+}
+
+/**
+ * Computes the minimum and maximum of the given values.
+ * As with Math.min() and Math.max(), NaN values are propagated: comparisons
+ * ignore them, but they are tracked on the side.
+ */
+template<typename T>
+static EASYJNI_ALWAYS_INLINE pair<T, T> minMaxKernel(const T *values, size_t size) {
+    T mins[LANES];
+    T maxs[LANES];
+    bool nans[LANES];
+    for (size_t l = 0; l < LANES; l++) {
+        mins[l] = numeric_limits<T>::max();
+        maxs[l] = numeric_limits<T>::lowest();
+        nans[l] = false;
+    }
+
+    // Updates the values of a lane with a new value.
+    auto update = [&mins, &maxs, &nans](size_t l, T value) {
+        mins[l] = (value < mins[l]) ? value : mins[l];
+        maxs[l] = (value > maxs[l]) ? value : maxs[l];
+        if constexpr (is_floating_point_v<T>) {
+            nans[l] |= isnan(value);
+        }
+    };
+
+    size_t i = 0;
+    for (; i + LANES <= size; i += LANES) {
+        for (size_t l = 0; l < LANES; l++) {
+            update(l, values[i + l]);
+        }
+    }
+    for (size_t l = 0; i < size; i++, l++) {
+        update(l, values[i]);
+    }
+
+    pair<T, T> result(mins[0], maxs[0]);
+    bool nan = nans[0];
+    for (size_t l = 1; l < LANES; l++) {
+        result.first = (mins[l] < result.first) ? mins[l] : result.first;
+        result.second = (maxs[l] > result.second) ? maxs[l] : result.second;
+        nan |= nans[l];
+    }
+    if constexpr (is_floating_point_v<T>) {
+        if (nan) {
+            return pair(numeric_limits<T>::quiet_NaN(), numeric_limits<T>::quiet_NaN());
+        }
+    }
+    return result;
+}
+
+/**
+ * Computes the dot product of two vectors.
+ */
+template<typename T, typename R>
+static EASYJNI_ALWAYS_INLINE R dotKernel(const T *x, const T *y, size_t size) {
+    R lanes[LANES] = {};
+    size_t i = 0;
+    for (; i + LANES <= size; i += LANES) {
+        for (size_t l = 0; l < LANES; l++) {
+            lanes[l] = add(lanes[l], multiply(static_cast<R>(x[i + l]), static_cast<R>(y[i + l])));
+        }
+    }
+
+    R result = 0;
+    for (; i < size; i++) {
+        result = add(result, multiply(static_cast<R>(x[i]), static_cast<R>(y[i])));
+    }
+    for (auto lane : lanes) {
+        result = add(result, lane);
+    }
+    return result;
+}
+
+/**
+ * Multiplies the given values by a factor.
+ */
+template<typename T>
+static EASYJNI_ALWAYS_INLINE void scaleKernel(T *values, size_t size, T factor) {
+    for (size_t i = 0; i < size; i++) {
+        values[i] = multiply(values[i], factor);
+    }
+}
+
+/**
+ * Computes y = a * x + y.
+ */
+template<typename T>
+static EASYJNI_ALWAYS_INLINE void axpyKernel(T a, const T *x, T *y, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        y[i] += a * x[i];
+    }
+}
+
+#ifdef EASYJNI_MULTIVERSIONING
+
+// The variants of the kernels compiled for AVX2 and AVX-512.
+// SSE2 being part of the x86-64 baseline, the portable variant covers it.
+
+template<typename T, typename R>
+EASYJNI_TARGET("avx2") static R sumAvx2(const T *values, size_t size) {
+    return sumKernel<T, R>(values, size);
+}
+
+template<typename T, typename R>
+EASYJNI_TARGET("avx512f,avx512bw,avx512vl,avx2") static R sumAvx512(const T *values, size_t size) {
+    return sumKernel<T, R>(values, size);
+}
+
+template<typename T>
+EASYJNI_TARGET("avx2") static pair<T, T> minMaxAvx2(const T *values, size_t size) {
+    return minMaxKernel<T>(values, size);
+}
+
+template<typename T>
+EASYJNI_TARGET("avx512f,avx512bw,avx512vl,avx2") static pair<T, T> minMaxAvx512(const T *values, size_t size) {
+    return minMaxKernel<T>(values, size);
+}
+
+template<typename T, typename R>
+EASYJNI_TARGET("avx2") static R dotAvx2(const T *x, const T *y, size_t size) {
+    return dotKernel<T, R>(x, y, size);
+}
+
+template<typename T, typename R>
+EASYJNI_TARGET("avx512f,avx512bw,avx512vl,avx2") static R dotAvx512(const T *x, const T *y, size_t size) {
+    return dotKernel<T, R>(x, y, size);
+}
+
+template<typename T>
+EASYJNI_TARGET("avx2") static void scaleAvx2(T *values, size_t size, T factor) {
+    scaleKernel<T>(values, size, factor);
+}
+
+template<typename T>
+EASYJNI_TARGET("avx512f,avx512bw,avx512vl,avx2") static void scaleAvx512(T *values, size_t size, T factor) {
+    scaleKernel<T>(values, size, factor);
+}
+
+template<typename T>
+EASYJNI_TARGET("avx2") static void axpyAvx2(T a, const T *x, T *y, size_t size) {
+    axpyKernel<T>(a, x, y, size);
+}
+
+template<typename T>
+EASYJNI_TARGET("avx512f,avx512bw,avx512vl,avx2") static void axpyAvx512(T a, const T *x, T *y, size_t size) {
+    axpyKernel<T>(a, x, y, size);
+}
+
+#endif
+
+/**
+ * Computes the sum of the given values with the best instruction set.
+ */
+template<typename T, typename R>
+static R sumOf(span<const T> values) {
+#ifdef EASYJNI_MULTIVERSIONING
+    if (instructionSet == InstructionSet::AVX512) {
+        return sumAvx512<T, R>(values.data(), values.size());
+    }
+    if (instructionSet == InstructionSet::AVX2) {
+        return sumAvx2<T, R>(values.data(), values.size());
+    }
+#endif
+    return sumKernel<T, R>(values.data(), values.size());
+}
+
+/**
+ * Computes the minimum and maximum of the given values with the best instruction set.
+ */
+template<typename T>
+static pair<T, T> minMaxOf(span<const T> values) {
+#ifdef EASYJNI_MULTIVERSIONING
+    if (instructionSet == InstructionSet::AVX512) {
+        return minMaxAvx512<T>(values.data(), values.size());
+    }
+    if (instructionSet == InstructionSet::AVX2) {
+        return minMaxAvx2<T>(values.data(), values.size());
+    }
+#endif
+    return minMaxKernel<T>(values.data(), values.size());
+}
+
+/**
+ * Computes the dot product of two vectors with the best instruction set.
+ */
+template<typename T, typename R>
+static R dotOf(span<const T> x, span<const T> y) {
+    if (x.size() != y.size()) {
+        throw JniException("Cannot compute the dot product of vectors of different lengths");
+    }
+
+#ifdef EASYJNI_MULTIVERSIONING
+    if (instructionSet == InstructionSet::AVX512) {
+        return dotAvx512<T, R>(x.data(), y.data(), x.size());
+    }
+    if (instructionSet == InstructionSet::AVX2) {
+        return dotAvx2<T, R>(x.data(), y.data(), x.size());
+    }
+#endif
+    return dotKernel<T, R>(x.data(), y.data(), x.size());
+}
+
+/**
+ * Multiplies the given values by a factor with the best instruction set.
+ */
+template<typename T>
+static void scaleOf(span<T> values, T factor) {
+#ifdef EASYJNI_MULTIVERSIONING
+    if (instructionSet == InstructionSet::AVX512) {
+        scaleAvx512<T>(values.data(), values.size(), factor);
+        return;
+    }
+    if (instructionSet == InstructionSet::AVX2) {
+        scaleAvx2<T>(values.data(), values.size(), factor);
+        return;
+    }
+#endif
+    scaleKernel<T>(values.data(), values.size(), factor);
+}
+
+/**
+ * Computes y = a * x + y with the best instruction set.
+ */
+template<typename T>
+static void axpyOf(T a, span<const T> x, span<T> y) {
+    if (x.size() != y.size()) {
+        throw JniException("Cannot compute axpy on vectors of different lengths");
+    }
+
+#ifdef EASYJNI_MULTIVERSIONING
+    if (instructionSet == InstructionSet::AVX512) {
+        axpyAvx512<T>(a, x.data(), y.data(), x.size());
+        return;
+    }
+    if (instructionSet == InstructionSet::AVX2) {
+        axpyAvx2<T>(a, x.data(), y.data(), x.size());
+        return;
+    }
+#endif
+    axpyKernel<T>(a, x.data(), y.data(), x.size());
+}
+
+/**
+ * The tables used to compute CRC-32 checksums eight bytes at a time (with the
+ * reflected polynomial used by java.util.zip.CRC32).
+ */
+static constexpr auto crcTables = [] {
+    array<array<uint32_t, 256>, 8> tables{};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1U) ? ((crc >> 1U) ^ 0xEDB88320U) : (crc >> 1U);
+        }
+        tables[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (size_t t = 1; t < 8; t++) {
+            tables[t][i] = (tables[t - 1][i] >> 8U) ^ tables[0][tables[t - 1][i] & 0xFFU];
+        }
+    }
+    return tables;
+}();
+
+/**
+ * The primes used by xxHash64.
+ */
+static constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+static constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+static constexpr uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+static constexpr uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+static constexpr uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+/**
+ * Rotates a 64-bit value to the left.
+ */
+static inline uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+/**
+ * Reads a little-endian value from the given bytes.
+ */
+template<typename V>
+static inline V readLittleEndian(const unsigned char *bytes) {
+    V value = 0;
+    for (size_t i = 0; i < sizeof(V); i++) {
+        value |= static_cast<V>(bytes[i]) << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * Performs a round of xxHash64.
+ */
+static inline uint64_t xxRound(uint64_t accumulator, uint64_t input) {
+    accumulator += input * PRIME2;
+    accumulator = rotateLeft(accumulator, 31);
+    return accumulator * PRIME1;
+}
+
+/**
+ * Merges an accumulator into the hash computed by xxHash64.
+ */
+static inline uint64_t xxMerge(uint64_t hash, uint64_t accumulator) {
+    hash ^= xxRound(0, accumulator);
+    return hash * PRIME1 + PRIME4;
+}
+
+const char *JavaArrayKernels::getInstructionSet() {
+    switch (instructionSet) {
+        case InstructionSet::AVX512:
+            return "avx512";
+
+        case InstructionSet::AVX2:
+            return "avx2";
+
+        case InstructionSet::SSE2:
+            return "sse2";
+
+        default:
+            return "scalar";
+    }
+}
+
+jlong JavaArrayKernels::sum(span<const jbyte> values) {
+    return sumOf<jbyte, jlong>(values);
+}
+
+jlong JavaArrayKernels::sum(span<const jshort> values) {
+    return sumOf<jshort, jlong>(values);
+}
+
+jlong JavaArrayKernels::sum(span<const jint> values) {
+    return sumOf<jint, jlong>(values);
+}
+
+jlong JavaArrayKernels::sum(span<const jlong> values) {
+    return sumOf<jlong, jlong>(values);
+}
+
+jdouble JavaArrayKernels::sum(span<const jfloat> values) {
+    return sumOf<jfloat, jdouble>(values);
+}
+
+jdouble JavaArrayKernels::sum(span<const jdouble> values) {
+    return sumOf<jdouble, jdouble>(values);
+}
+
+pair<jbyte, jbyte> JavaArrayKernels::minMax(span<const jbyte> values) {
+    return minMaxOf<jbyte>(values);
+}
+
+pair<jshort, jshort> JavaArrayKernels::minMax(span<const jshort> values) {
+    return minMaxOf<jshort>(values);
+}
+
+pair<jint, jint> JavaArrayKernels::minMax(span<const jint> values) {
+    return minMaxOf<jint>(values);
+}
+
+pair<jlong, jlong> JavaArrayKernels::minMax(span<const jlong> values) {
+    return minMaxOf<jlong>(values);
+}
+
+pair<jfloat, jfloat> JavaArrayKernels::minMax(span<const jfloat> values) {
+    return minMaxOf<jfloat>(values);
+}
+
+pair<jdouble, jdouble> JavaArrayKernels::minMax(span<const jdouble> values) {
+    return minMaxOf<jdouble>(values);
+}
+
+jlong JavaArrayKernels::dot(span<const jint> x, span<const jint> y) {
+    return dotOf<jint, jlong>(x, y);
+}
+
+jfloat JavaArrayKernels::dot(span<const jfloat> x, span<const jfloat> y) {
+    return dotOf<jfloat, jfloat>(x, y);
+}
+
+jdouble JavaArrayKernels::dot(span<const jdouble> x, span<const jdouble> y) {
+    return dotOf<jdouble, jdouble>(x, y);
+}
+
+void JavaArrayKernels::scale(span<jint> values, jint factor) {
+    scaleOf<jint>(values, factor);
+}
+
+void JavaArrayKernels::scale(span<jlong> values, jlong factor) {
+    scaleOf<jlong>(values, factor);
+}
+
+void JavaArrayKernels::scale(span<jfloat> values, jfloat factor) {
+    scaleOf<jfloat>(values, factor);
+}
+
+void JavaArrayKernels::scale(span<jdouble> values, jdouble factor) {
+    scaleOf<jdouble>(values, factor);
+}
+
+void JavaArrayKernels::axpy(jfloat a, span<const jfloat> x, span<jfloat> y) {
+    axpyOf<jfloat>(a, x, y);
+}
+
+void JavaArrayKernels::axpy(jdouble a, span<const jdouble> x, span<jdouble> y) {
+    axpyOf<jdouble>(a, x, y);
+}
+
+array<uint64_t, 256> JavaArrayKernels::histogram(span<const jbyte> bytes) {
+    // Using several tables breaks the dependency between consecutive equal bytes.
+    array<array<uint64_t, 256>, 4> tables{};
+    auto data = reinterpret_cast<const unsigned char *>(bytes.data());
+    size_t i = 0;
+    for (; i + 4 <= bytes.size(); i += 4) {
+        tables[0][data[i]]++;
+        tables[1][data[i + 1]]++;
+        tables[2][data[i + 2]]++;
+        tables[3][data[i + 3]]++;
+    }
+    for (; i < bytes.size(); i++) {
+        tables[0][data[i]]++;
+    }
+
+    array<uint64_t, 256> result{};
+    for (size_t b = 0; b < 256; b++) {
+        result[b] = tables[0][b] + tables[1][b] + tables[2][b] + tables[3][b];
+    }
+    return result;
+}
+
+uint32_t JavaArrayKernels::crc32(span<const jbyte> bytes, uint32_t crc) {
+    // Using slicing-by-8 to process eight bytes per iteration.
+    auto data = reinterpret_cast<const unsigned char *>(bytes.data());
+    size_t size = bytes.size();
+    crc = ~crc;
+    for (; size >= 8; data += 8, size -= 8) {
+        uint32_t low = readLittleEndian<uint32_t>(data) ^ crc;
+        uint32_t high = readLittleEndian<uint32_t>(data + 4);
+        crc = crcTables[7][low & 0xFFU] ^ crcTables[6][(low >> 8U) & 0xFFU]
+              ^ crcTables[5][(low >> 16U) & 0xFFU] ^ crcTables[4][low >> 24U]
+              ^ crcTables[3][high & 0xFFU] ^ crcTables[2][(high >> 8U) & 0xFFU]
+              ^ crcTables[1][(high >> 16U) & 0xFFU] ^ crcTables[0][high >> 24U];
+    }
+    for (; size > 0; data++, size--) {
+        crc = (crc >> 8U) ^ crcTables[0][(crc ^ *data) & 0xFFU];
+    }
+    return ~crc;
+}
+
+uint64_t JavaArrayKernels::xxHash64(span<const jbyte> bytes, uint64_t seed) {
+    auto data = reinterpret_cast<const unsigned char *>(bytes.data());
+    auto end = data + bytes.size();
+    uint64_t hash;
+
+    // Processing stripes of 32 bytes with four independent accumulators.
+    if (bytes.size() >= 32) {
+        uint64_t v1 = seed + PRIME1 + PRIME2;
+        uint64_t v2 = seed + PRIME2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME1;
+        for (; data + 32 <= end; data += 32) {
+            v1 = xxRound(v1, readLittleEndian<uint64_t>(data));
+            v2 = xxRound(v2, readLittleEndian<uint64_t>(data + 8));
+            v3 = xxRound(v3, readLittleEndian<uint64_t>(data + 16));
+            v4 = xxRound(v4, readLittleEndian<uint64_t>(data + 24));
+        }
+        hash = rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+        hash = xxMerge(hash, v1);
+        hash = xxMerge(hash, v2);
+        hash = xxMerge(hash, v3);
+        hash = xxMerge(hash, v4);
+
+    } else {
+        hash = seed + PRIME5;
+    }
+    hash += bytes.size();
+
+    // Processing the remaining bytes.
+    for (; data + 8 <= end; data += 8) {
+        hash ^= xxRound(0, readLittleEndian<uint64_t>(data));
+        hash = rotateLeft(hash, 27) * PRIME1 + PRIME4;
+    }
+    if (data + 4 <= end) {
+        hash ^= readLittleEndian<uint32_t>(data) * PRIME1;
+        hash = rotateLeft(hash, 23) * PRIME2 + PRIME3;
+        data += 4;
+    }
+    for (; data < end; data++) {
+        hash ^= (*data) * PRIME5;
+        hash = rotateLeft(hash, 11) * PRIME1;
+    }
+
+    // Mixing the bits of the hash.
+    hash ^= hash >> 33U;
+    hash *= PRIME2;
+    hash ^= hash >> 29U;
+    hash *= PRIME3;
+    hash ^= hash >> 32U;
+    return hash;
+}
@@ -0,0 +1,195 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#include "crillab-easyjni/JavaBulkDispatcher.h"
+#include "crillab-easyjni/JavaVirtualMachineRegistry.h"
+
+using namespace easyjni;
+using namespace std;
+
+/**
+ * Loads the helper class used to dispatch the calls.
+ *
+ * @return The helper class.
+ *
+ * @throws JniException If no Java Virtual Machine has been registered yet.
+ */
+static JavaClass loadDispatcherClass() {
+    auto jvm = JavaVirtualMachineRegistry::get();
+    if (jvm == nullptr) {
+        throw JniException("No Java Virtual Machine has been registered");
+    }
+    return jvm->loadClass(JavaBulkDispatcher::CLASS_NAME);
+}
+
+JavaBulkDispatcher::JavaBulkDispatcher(int32_t nbSlots) :
+        dispatcherClass(loadDispatcherClass()),
+        dispatchMethod(dispatcherClass.getStaticMethod<
+                void(JavaReference<"java/nio/ByteBuffer">, JavaArray<JObject>, JavaArray<JObject>)>("dispatch")),
+        prepareMethod(dispatcherClass.getStaticMethod<JavaReference<"java/lang/invoke/MethodHandle">(
+                JavaReference<"java/lang/reflect/AccessibleObject">)>("prepare")),
+        clearMethod(dispatcherClass.getStaticMethod<void(JavaArray<JObject>, jint)>("clear")),
+        slots(nullptr),
+        nbSlots(nbSlots),
+        nbUsedSlots(0),
+        targets(),
+        targetIndices(),
+        targetArray(nullptr),
+        calls(),
+        nbCalls(0) {
+    // Allocating the slots.
+    auto env = JavaVirtualMachineRegistry::getEnvironment();
+    auto objectClass = JavaVirtualMachineRegistry::get()->loadClass("java/lang/Object");
+    jobjectArray localSlots = env->NewObjectArray(nbSlots, *objectClass, nullptr);
+    if (localSlots == nullptr) {
+        JavaVirtualMachineRegistry::get()->checkException();
+        throw JniException("Could not allocate the slots of the dispatcher");
+    }
+    slots = static_cast<jobjectArray>(env->NewGlobalRef(localSlots));
+    env->DeleteLocalRef(localSlots);
+}
+
+JavaBulkDispatcher::~JavaBulkDispatcher() {
+    auto env = JavaVirtualMachineRegistry::getEnvironment();
+    if (env == nullptr) {
+        // The JVM has already been destroyed, and so have the references.
+        return;
+    }
+
+    for (auto target : targets) {
+        env->DeleteGlobalRef(target);
+    }
+    if (targetArray != nullptr) {
+        env->DeleteGlobalRef(targetArray);
+    }
+    env->DeleteGlobalRef(slots);
+}
+
+JavaSlot JavaBulkDispatcher::bind(JavaObject object) {
+    auto slot = newSlot();
+    JavaVirtualMachineRegistry::getEnvironment()->SetObjectArrayElement(slots, slot.index, *object);
+    JavaVirtualMachineRegistry::get()->checkException();
+    return slot;
+}
+
+JavaObject JavaBulkDispatcher::get(JavaSlot slot) {
+    if (slot.index < 0) {
+        return JavaObject(nullptr);
+    }
+    auto object = JavaVirtualMachineRegistry::getEnvironment()->GetObjectArrayElement(slots, slot.index);
+    JavaVirtualMachineRegistry::get()->checkException();
+    return JavaObject(object);
+}
+
+void JavaBulkDispatcher::flush() {
+    flush(JavaVirtualMachineRegistry::getContext());
+}
+
+void JavaBulkDispatcher::flush(const JavaContext &context) {
+    if (nbCalls == 0) {
+        return;
+    }
+
+    // Wrapping the packed calls into a direct buffer, without copying them.
+    auto env = context.getEnvironment();
+    updateTargetArray(env);
+    jobject buffer = env->NewDirectByteBuffer(calls.data(), static_cast<jlong>(calls.size()));
+    if (buffer == nullptr) {
+        calls.clear();
+        nbCalls = 0;
+        context.checkException();
+        throw JniException("Could not wrap the calls into a direct buffer");
+    }
+
+    // Executing all the calls in a single downcall.
+    auto deferred = context.withExceptionPolicy(JavaContext::ExceptionPolicy::DEFERRED);
+    dispatchMethod.invokeStatic(deferred, dispatcherClass, buffer, targetArray, slots);
+    env->DeleteLocalRef(buffer);
+    calls.clear();
+    nbCalls = 0;
+    context.afterCall();
+}
+
+void JavaBulkDispatcher::reset() {
+    calls.clear();
+    nbCalls = 0;
+    if (nbUsedSlots > 0) {
+        clearMethod.invokeStatic(dispatcherClass, slots, nbUsedSlots);
+        nbUsedSlots = 0;
+    }
+}
+
+int32_t JavaBulkDispatcher::targetOf(jclass clazz, jmethodID method, bool isStatic) {
+    // Looking for the target among those already recorded.
+    auto it = targetIndices.find(method);
+    if (it != targetIndices.end()) {
+        return it->second;
+    }
+
+    // Reflecting the method, so that the helper class can create its method handle.
+    auto env = JavaVirtualMachineRegistry::getEnvironment();
+    jobject reflected = env->ToReflectedMethod(clazz, method, isStatic ? JNI_TRUE : JNI_FALSE);
+    if (reflected == nullptr) {
+        JavaVirtualMachineRegistry::get()->checkException();
+        throw JniException("Could not reflect a method to dispatch");
+    }
+    auto handle = prepareMethod.invokeStatic(dispatcherClass, reflected);
+    env->DeleteLocalRef(reflected);
+
+    // Recording the new target.
+    auto index = static_cast<int32_t>(targets.size());
+    targets.push_back(env->NewGlobalRef(*handle));
+    env->DeleteLocalRef(*handle);
+    targetIndices.emplace(method, index);
+    return index;
+}
+
+JavaSlot JavaBulkDispatcher::newSlot() {
+    if (nbUsedSlots >= nbSlots) {
+        throw JniException("No more slots available in the dispatcher");
+    }
+    return JavaSlot{nbUsedSlots++};
+}
+
+void JavaBulkDispatcher::updateTargetArray(JNIEnv *env) {
+    auto size = static_cast<jsize>(targets.size());
+    if ((targetArray != nullptr) && (env->GetArrayLength(targetArray) == size)) {
+        // No target has been recorded since the array has been built.
+        return;
+    }
+
+    // Building the new array of targets.
+    auto objectClass = JavaVirtualMachineRegistry::get()->loadClass("java/lang/Object");
+    jobjectArray localArray = env->NewObjectArray(size, *objectClass, nullptr);
+    if (localArray == nullptr) {
+        JavaVirtualMachineRegistry::get()->checkException();
+        throw JniException("Could not allocate the targets of the dispatcher");
+    }
+    for (jsize i = 0; i < size; i++) {
+        env->SetObjectArrayElement(localArray, i, targets[static_cast<size_t>(i)]);
+    }
+
+    // Replacing the previous array.
+    if (targetArray != nullptr) {
+        env->DeleteGlobalRef(targetArray);
+    }
+    targetArray = static_cast<jobjectArray>(env->NewGlobalRef(localArray));
+    env->DeleteLocalRef(localArray);
+}
@@ -18,14 +18,22 @@
  * If not, see {@link http://www.gnu.org/licenses}.
  */
 
+#include <algorithm>
+
 #include "crillab-easyjni/JavaClass.h"
 #include "crillab-easyjni/JavaField.h"
+#include "crillab-easyjni/JavaMemberCache.h"
 #include "crillab-easyjni/JavaMethod.h"
+#include "crillab-easyjni/JavaVirtualMachineRegistry.h"
 #include "crillab-easyjni/JniException.h"
 
 using namespace easyjni;
 using namespace std;
 
+unordered_multimap<string, JavaClass::CachedMetadata> JavaClass::metadataCache;
+size_t JavaClass::metadataPruneSize = JavaClass::MIN_METADATA_PRUNE_SIZE;
+shared_mutex JavaClass::metadataMutex;
+
 JavaClass::JavaClass(string name, jclass nativeClass) :
         JavaElement(std::move(name)),
         nativeClass(nativeClass) {
@@ -40,33 +48,73 @@ JavaObject JavaClass::asObject() {
     return JavaObject(nativeClass);
 }
 
+shared_ptr<const JavaClassMetadata> JavaClass::getMetadata() {
+    auto env = getEnvironment();
+
+    // Classes with an unknown name (e.g., the class of an object) are compared to all cached classes.
+    bool named = JavaMemberCache::isNamed(getName());
+    auto name = named ? getBinaryName() : string();
+    auto findCached = [this, env, named, &name]() -> shared_ptr<const JavaClassMetadata> {
+        auto [first, last] = named ? metadataCache.equal_range(name)
+                                   : make_pair(metadataCache.begin(), metadataCache.end());
+        for (auto cached = first; cached != last; ++cached) {
+            if (env->IsSameObject(cached->second.nativeClass, nativeClass)) {
+                return cached->second.metadata;
+            }
+        }
+        return nullptr;
+    };
+
+    // Looking for the metadata in the cache.
+    {
+        shared_lock<shared_mutex> lock(metadataMutex);
+        if (auto cached = findCached()) {
+            return cached;
+        }
+    }
+
+    // The metadata has to be computed, unless another thread did it in the meantime.
+    auto metadata = make_shared<const JavaClassMetadata>(computeMetadata());
+    unique_lock<shared_mutex> lock(metadataMutex);
+    if (auto cached = findCached()) {
+        return cached;
+    }
+
+    // The classes that have been unloaded are removed once the cache has doubled in size.
+    if (metadataCache.size() >= metadataPruneSize) {
+        for (auto cached = metadataCache.begin(); cached != metadataCache.end();) {
+            if (env->IsSameObject(cached->second.nativeClass, nullptr)) {
+                env->DeleteWeakGlobalRef(cached->second.nativeClass);
+                cached = metadataCache.erase(cached);
+            } else {
+                ++cached;
+            }
+        }
+        metadataPruneSize = max(MIN_METADATA_PRUNE_SIZE, 2 * metadataCache.size());
+    }
+    metadataCache.emplace(metadata->name, CachedMetadata {env->NewWeakGlobalRef(nativeClass), metadata});
+    return metadata;
+}
+
 bool JavaClass::isArray() {
-    auto metaClass = asObject();
-    auto rootClass = metaClass.getClass();
-    auto method = rootClass.getBooleanMethod("isArray");
-    return method.invoke(metaClass);
+    return getMetadata()->array;
 }
 
 string JavaClass::getCanonicalName() {
-    auto metaClass = asObject();
-    auto rootClass = metaClass.getClass();
-    auto method = rootClass.getObjectMethod("getCanonicalName", METHOD(CLASS(java/lang/String)));
-    auto canonicalName = method.invoke(metaClass);
-    return canonicalName.toString();
+    return getMetadata()->canonicalName;
 }
 
 bool JavaClass::isAssignableFrom(JavaClass &cls) {
-    auto metaClass = asObject();
-    auto rootClass = metaClass.getClass();
-    auto method = rootClass.getBooleanMethod("isAssignableFrom", METHOD(BOOLEAN, CLASS(java/lang/Class)));
-    return method.invoke(metaClass, *cls);
+    // JNI checks whether its first argument can be cast to its second argument.
+    auto assignable = getEnvironment()->IsAssignableFrom(cls.nativeClass, nativeClass);
+    checkException();
+    return assignable;
 }
 
 bool JavaClass::isInstance(JavaObject &object) {
-    auto metaClass = asObject();
-    auto rootClass = metaClass.getClass();
-    auto method = rootClass.getBooleanMethod("isInstance", METHOD(BOOLEAN, CLASS(java/lang/Object)));
-    return method.invoke(metaClass, *object);
+    auto instance = getEnvironment()->IsInstanceOf(object.nativeObject, nativeClass);
+    checkException();
+    return instance;
 }
 
 JavaField<jboolean> JavaClass::getBooleanField(const string &name) {
@@ -110,7 +158,7 @@ JavaField<jdouble> JavaClass::getDoubleField(const string &name) {
 }
 
 JavaField<JavaObject> JavaClass::getObjectField(const string &name, const string &signature) {
-    jfieldID field = getFieldID(name, signature);
+    jfieldID field = getFieldID(name, signature.c_str());
     return JavaField<JavaObject>::newInstance(name, field);
 }
 
@@ -155,23 +203,13 @@ JavaField<jdouble> JavaClass::getStaticDoubleField(const string &name) {
 }
 
 JavaField<JavaObject> JavaClass::getStaticObjectField(const string &name, const string &signature) {
-    jfieldID field = getStaticFieldID(name, signature);
+    jfieldID field = getStaticFieldID(name, signature.c_str());
     return JavaField<JavaObject>::newInstance(name, field);
 }
 
 JavaMethod<JavaObject> JavaClass::getConstructor(const string &signature) {
-    jmethodID constructor = getMethodID("<init>", signature);
-    return JavaMethod<JavaObject>(
-        "<init>",
-        constructor,
-        [](JNIEnv *env, jobject obj, jmethodID mtd, va_list args) -> JavaObject {
-            throw JniException("Cannot invoke a constructor on an instance");
-        },
-        [](JNIEnv *env, jclass cls, jmethodID mtd, va_list args) -> JavaObject {
-            jobject res = env->NewObjectV(cls, mtd, args);
-            return JavaObject(res);
-        }
-    );
+    jmethodID constructor = getMethodID("<init>", signature.c_str());
+    return JavaMethod<JavaObject>("<init>", constructor, true);
 }
 
 JavaObject JavaClass::newInstance() {
@@ -185,137 +223,231 @@ JavaObject JavaClass::newInstance() {
 }
 
 JavaMethod<void *> JavaClass::getMethod(const string &name, const string &signature) {
-    jmethodID method = getMethodID(name, signature);
+    jmethodID method = getMethodID(name, signature.c_str());
     return JavaMethod<void *>::newInstance(name, method);
 }
 
 JavaMethod<jboolean> JavaClass::getBooleanMethod(const string &name, const string &signature) {
-    jmethodID method = getMethodID(name, signature);
+    jmethodID method = getMethodID(name, signature.c_str());
     return JavaMethod<jboolean>::newInstance(name, method);
 }
 
 JavaMethod<jbyte> JavaClass::getByteMethod(const string &name, const string &signature) {
-    jmethodID method = getMethodID(name, signature);
+    jmethodID method = getMethodID(name, signature.c_str());
     return JavaMethod<jbyte>::newInstance(name, method);
 }
 
 JavaMethod<jchar> JavaClass::getCharMethod(const string &name, const string &signature) {
-    jmethodID method = getMethodID(name, signature);
+    jmethodID method = getMethodID(name, signature.c_str());
     return JavaMethod<jchar>::newInstance(name, method);
 }
 
 JavaMethod<jshort> JavaClass::getShortMethod(const string &name, const string &signature) {
-    jmethodID method = getMethodID(name, signature);
+    jmethodID method = getMethodID(name, signature.c_str());
     return JavaMethod<jshort>::newInstance(name, method);
 }
 
 JavaMethod<jint> JavaClass::getIntMethod(const string &name, const string &signature) {
-    jmethodID method = getMethodID(name, signature);
+    jmethodID method = getMethodID(name, signature.c_str());
     return JavaMethod<jint>::newInstance(name, method);
 }
 
 JavaMethod<jlong> JavaClass::getLongMethod(const string &name, const string &signature) {
-    jmethodID method = getMethodID(name, signature);
+    jmethodID method = getMethodID(name, signature.c_str());
     return JavaMethod<jlong>::newInstance(name, method);
 }
 
 JavaMethod<jfloat> JavaClass::getFloatMethod(const string &name, const string &signature) {
-    jmethodID method = getMethodID(name, signature);
+    jmethodID method = getMethodID(name, signature.c_str());
     return JavaMethod<jfloat>::newInstance(name, method);
 }
 
 JavaMethod<jdouble> JavaClass::getDoubleMethod(const string &name, const string &signature) {
-    jmethodID method = getMethodID(name, signature);
+    jmethodID method = getMethodID(name, signature.c_str());
     return JavaMethod<jdouble>::newInstance(name, method);
 }
 
 JavaMethod<JavaObject> JavaClass::getObjectMethod(const string &name, const string &signature) {
-    jmethodID method = getMethodID(name, signature);
+    jmethodID method = getMethodID(name, signature.c_str());
     return JavaMethod<JavaObject>::newInstance(name, method);
 }
 
 JavaMethod<void *> JavaClass::getStaticMethod(const string &name, const string &signature) {
-    jmethodID method = getStaticMethodID(name, signature);
+    jmethodID method = getStaticMethodID(name, signature.c_str());
     return JavaMethod<void *>::newInstance(name, method);
 }
 
 JavaMethod<jboolean> JavaClass::getStaticBooleanMethod(const string &name, const string &signature) {
-    jmethodID method = getStaticMethodID(name, signature);
+    jmethodID method = getStaticMethodID(name, signature.c_str());
     return JavaMethod<jboolean>::newInstance(name, method);
 }
 
 JavaMethod<jbyte> JavaClass::getStaticByteMethod(const string &name, const string &signature) {
-    jmethodID method = getStaticMethodID(name, signature);
+    jmethodID method = getStaticMethodID(name, signature.c_str());
     return JavaMethod<jbyte>::newInstance(name, method);
 }
 
 JavaMethod<jchar> JavaClass::getStaticCharMethod(const string &name, const string &signature) {
-    jmethodID method = getStaticMethodID(name, signature);
+    jmethodID method = getStaticMethodID(name, signature.c_str());
     return JavaMethod<jchar>::newInstance(name, method);
 }
 
 JavaMethod<jshort> JavaClass::getStaticShortMethod(const string &name, const string &signature) {
-    jmethodID method = getStaticMethodID(name, signature);
+    jmethodID method = getStaticMethodID(name, signature.c_str());
     return JavaMethod<jshort>::newInstance(name, method);
 }
 
 JavaMethod<jint> JavaClass::getStaticIntMethod(const string &name, const string &signature) {
-    jmethodID method = getStaticMethodID(name, signature);
+    jmethodID method = getStaticMethodID(name, signature.c_str());
     return JavaMethod<jint>::newInstance(name, method);
 }
 
 JavaMethod<jlong> JavaClass::getStaticLongMethod(const string &name, const string &signature) {
-    jmethodID method = getStaticMethodID(name, signature);
+    jmethodID method = getStaticMethodID(name, signature.c_str());
     return JavaMethod<jlong>::newInstance(name, method);
 }
 
 JavaMethod<jfloat> JavaClass::getStaticFloatMethod(const string &name, const string &signature) {
-    jmethodID method = getStaticMethodID(name, signature);
+    jmethodID method = getStaticMethodID(name, signature.c_str());
     return JavaMethod<jfloat>::newInstance(name, method);
 }
 
 JavaMethod<jdouble> JavaClass::getStaticDoubleMethod(const string &name, const string &signature) {
-    jmethodID method = getStaticMethodID(name, signature);
+    jmethodID method = getStaticMethodID(name, signature.c_str());
     return JavaMethod<jdouble>::newInstance(name, method);
 }
 
 JavaMethod<JavaObject> JavaClass::getStaticObjectMethod(const string &name, const string &signature) {
-    jmethodID method = getStaticMethodID(name, signature);
+    jmethodID method = getStaticMethodID(name, signature.c_str());
     return JavaMethod<JavaObject>::newInstance(name, method);
 }
 
-jfieldID JavaClass::getFieldID(const string &name, const string &signature) {
-    jfieldID field = getEnvironment()->GetFieldID(nativeClass, name.c_str(), signature.c_str());
+jfieldID JavaClass::getFieldID(const string &name, const char *signature) {
+    // Looking for the field in the cache.
+    auto env = getEnvironment();
+    auto kind = JavaMemberCache::Kind::FIELD;
+    auto cached = JavaMemberCache::find(env, kind, nativeClass, getName(), name, signature);
+    if (cached != nullptr) {
+        return static_cast<jfieldID>(cached);
+    }
+
+    // Looking for the field in the JVM.
+    jfieldID field = env->GetFieldID(nativeClass, name.c_str(), signature);
     if (field == nullptr) {
         checkException();
         throw JniException("Could not find field " + name + " for class " + getName());
     }
+    JavaMemberCache::insert(env, kind, nativeClass, getName(), name, signature, field);
     return field;
 }
 
-jfieldID JavaClass::getStaticFieldID(const string &name, const string &signature) {
-    jfieldID field = getEnvironment()->GetStaticFieldID(nativeClass, name.c_str(), signature.c_str());
+jfieldID JavaClass::getStaticFieldID(const string &name, const char *signature) {
+    // Looking for the static field in the cache.
+    auto env = getEnvironment();
+    auto kind = JavaMemberCache::Kind::STATIC_FIELD;
+    auto cached = JavaMemberCache::find(env, kind, nativeClass, getName(), name, signature);
+    if (cached != nullptr) {
+        return static_cast<jfieldID>(cached);
+    }
+
+    // Looking for the static field in the JVM.
+    jfieldID field = env->GetStaticFieldID(nativeClass, name.c_str(), signature);
     if (field == nullptr) {
         checkException();
         throw JniException("Could not find static field " + name + " for class " + getName());
     }
+    JavaMemberCache::insert(env, kind, nativeClass, getName(), name, signature, field);
     return field;
 }
 
-jmethodID JavaClass::getMethodID(const string &name, const string &signature) {
-    jmethodID method = getEnvironment()->GetMethodID(nativeClass, name.c_str(), signature.c_str());
+jmethodID JavaClass::getMethodID(const string &name, const char *signature) {
+    // Looking for the method in the cache.
+    auto env = getEnvironment();
+    auto kind = JavaMemberCache::Kind::METHOD;
+    auto cached = JavaMemberCache::find(env, kind, nativeClass, getName(), name, signature);
+    if (cached != nullptr) {
+        return static_cast<jmethodID>(cached);
+    }
+
+    // Looking for the method in the JVM.
+    jmethodID method = env->GetMethodID(nativeClass, name.c_str(), signature);
     if (method == nullptr) {
         checkException();
         throw JniException("Could not find method " + name + " for class " + getName());
     }
+    JavaMemberCache::insert(env, kind, nativeClass, getName(), name, signature, method);
     return method;
 }
 
-jmethodID JavaClass::getStaticMethodID(const string &name, const string &signature) {
-    jmethodID method = getEnvironment()->GetStaticMethodID(nativeClass, name.c_str(), signature.c_str());
+jmethodID JavaClass::getStaticMethodID(const string &name, const char *signature) {
+    // Looking for the static method in the cache.
+    auto env = getEnvironment();
+    auto kind = JavaMemberCache::Kind::STATIC_METHOD;
+    auto cached = JavaMemberCache::find(env, kind, nativeClass, getName(), name, signature);
+    if (cached != nullptr) {
+        return static_cast<jmethodID>(cached);
+    }
+
+    // Looking for the static method in the JVM.
+    jmethodID method = env->GetStaticMethodID(nativeClass, name.c_str(), signature);
     if (method == nullptr) {
         checkException();
         throw JniException("Could not find static method " + name + " for class " + getName());
     }
+    JavaMemberCache::insert(env, kind, nativeClass, getName(), name, signature, method);
     return method;
 }
+
+string JavaClass::getBinaryName() {
+    // The binary name only differs from the JNI name by its separators.
+    auto name = getName();
+    replace(name.begin(), name.end(), '/', '.');
+    return name;
+}
+
+JavaClassMetadata JavaClass::computeMetadata() {
+    // Looking up the methods of java.lang.Class that are needed.
+    auto env = getEnvironment();
+    auto rootClass = JavaVirtualMachineRegistry::get()->loadClass("java/lang/Class");
+    auto getNameMethod = rootClass.getMethod<JString()>("getName");
+    auto getCanonicalNameMethod = rootClass.getMethod<JString()>("getCanonicalName");
+    auto isArrayMethod = rootClass.getMethod<jboolean()>("isArray");
+    auto getComponentTypeMethod = rootClass.getMethod<JClass()>("getComponentType");
+
+    // Converts a (local) Java string into a C++ string, and deletes the Java string.
+    auto consume = [env](JavaObject javaString) {
+        string str = javaString.isNull() ? "" : javaString.toString();
+        env->DeleteLocalRef(javaString.nativeObject);
+        return str;
+    };
+
+    // Describing the class itself.
+    JavaClassMetadata metadata;
+    auto metaClass = asObject();
+    metadata.name = consume(getNameMethod.invoke(metaClass));
+    metadata.canonicalName = consume(getCanonicalNameMethod.invoke(metaClass));
+    metadata.array = isArrayMethod.invoke(metaClass);
+    if (metadata.array) {
+        auto componentType = getComponentTypeMethod.invoke(metaClass);
+        metadata.componentType = consume(getNameMethod.invoke(componentType));
+        env->DeleteLocalRef(componentType.nativeObject);
+    }
+
+    // Describing its superclasses.
+    for (jclass superclass = env->GetSuperclass(nativeClass); superclass != nullptr;) {
+        metadata.superclasses.push_back(consume(getNameMethod.invoke(JavaObject(superclass))));
+        jclass next = env->GetSuperclass(superclass);
+        env->DeleteLocalRef(superclass);
+        superclass = next;
+    }
+    return metadata;
+}
+
+void JavaClass::clearMetadataCache(JNIEnv *env) {
+    unique_lock<shared_mutex> lock(metadataMutex);
+    for (auto &cached : metadataCache) {
+        env->DeleteWeakGlobalRef(cached.second.nativeClass);
+    }
+    metadataCache.clear();
+    metadataPruneSize = MIN_METADATA_PRUNE_SIZE;
+}
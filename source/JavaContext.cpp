@@ -0,0 +1,43 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#include "crillab-easyjni/JavaContext.h"
+#include "crillab-easyjni/JavaObject.h"
+#include "crillab-easyjni/JniException.h"
+
+using namespace easyjni;
+using namespace std;
+
+JavaContext::JavaContext(JNIEnv *env, ExceptionPolicy policy) :
+        env(env),
+        policy(policy) {
+    // Nothing to do: everything is already initialized.
+}
+
+void JavaContext::checkException() const {
+    assert(!isInCriticalRegion() && "No JNI call may be performed while a CriticalView is held");
+    if (env->ExceptionCheck()) {
+        JavaObject except(env->ExceptionOccurred());
+        env->ExceptionClear();
+        auto message = except.toString();
+        env->DeleteLocalRef(except.nativeObject);
+        throw JniException(message);
+    }
+}
@@ -0,0 +1,260 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <string>
+
+#include "crillab-easyjni/JavaClass.h"
+#include "crillab-easyjni/JavaDirectBuffer.h"
+#include "crillab-easyjni/JavaField.h"
+#include "crillab-easyjni/JavaMethod.h"
+#include "crillab-easyjni/JavaSignature.h"
+#include "crillab-easyjni/JavaVirtualMachineRegistry.h"
+#include "crillab-easyjni/JniException.h"
+
+using namespace easyjni;
+using namespace std;
+
+/**
+ * The Java type of byte orders.
+ */
+using JByteOrder = JavaReference<"java/nio/ByteOrder">;
+
+/**
+ * The Java type of byte buffers.
+ */
+using JByteBuffer = JavaReference<"java/nio/ByteBuffer">;
+
+/**
+ * The memory of the destroyed owning buffers, together with a weak reference
+ * to their ByteBuffer, which may still be reachable from Java code.
+ */
+static vector<pair<jweak, shared_ptr<void>>> graveyard;
+
+/**
+ * The mutex used to avoid concurrent accesses to the graveyard.
+ */
+static mutex graveyardMutex;
+
+JavaDirectBuffer::JavaDirectBuffer(
+        void *address, size_t capacity, shared_ptr<void> owner, ByteOrder order, bool readOnly) :
+        buffer(nullptr),
+        root(nullptr),
+        address(address),
+        capacity(capacity),
+        owner(std::move(owner)) {
+    if (capacity > MAX_CAPACITY) {
+        throw JniException("Cannot create a direct buffer of " + to_string(capacity) + " bytes");
+    }
+
+    auto env = JavaVirtualMachineRegistry::getEnvironment();
+    if (env == nullptr) {
+        throw JniException("No Java Virtual Machine has been registered");
+    }
+
+    if (this->owner != nullptr) {
+        // The memory of the buffers collected in the meantime is released before more is held.
+        reclaim();
+    }
+
+    jobject localBuffer = env->NewDirectByteBuffer(address, static_cast<jlong>(capacity));
+    if (localBuffer == nullptr) {
+        JavaVirtualMachineRegistry::get()->checkException();
+        throw JniException("Could not create a direct buffer");
+    }
+    buffer = env->NewGlobalRef(localBuffer);
+    if (this->owner != nullptr) {
+        // If no weak reference can be created, the memory is never reclaimed.
+        root = env->NewWeakGlobalRef(localBuffer);
+        if (root == nullptr) {
+            env->ExceptionClear();
+        }
+    }
+    env->DeleteLocalRef(localBuffer);
+
+    try {
+        if (readOnly) {
+            // The read-only buffer replaces the original one, which is never exposed.
+            auto readOnlyBuffer = view("asReadOnlyBuffer", "java/nio/ByteBuffer");
+            env->DeleteGlobalRef(buffer);
+            buffer = env->NewGlobalRef(*readOnlyBuffer);
+            env->DeleteLocalRef(*readOnlyBuffer);
+        }
+
+        // Java buffers are big-endian unless told otherwise.
+        if ((order == ByteOrder::LITTLE) || ((order == ByteOrder::NATIVE) && (endian::native == endian::little))) {
+            setByteOrder(ByteOrder::LITTLE);
+        }
+
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+JavaDirectBuffer JavaDirectBuffer::allocate(size_t capacity, ByteOrder order, size_t alignment) {
+    if (capacity > MAX_CAPACITY) {
+        throw JniException("Cannot create a direct buffer of " + to_string(capacity) + " bytes");
+    }
+
+    auto memory = ::operator new[](capacity, align_val_t(alignment));
+    shared_ptr<void> owner(memory, [alignment](void *ptr) {
+        ::operator delete[](ptr, align_val_t(alignment));
+    });
+    memset(memory, 0, capacity);
+    return JavaDirectBuffer(memory, capacity, std::move(owner), order);
+}
+
+span<byte> JavaDirectBuffer::getMemory(JavaObject buffer) {
+    auto env = JavaVirtualMachineRegistry::getEnvironment();
+    auto memory = env->GetDirectBufferAddress(*buffer);
+    auto capacity = env->GetDirectBufferCapacity(*buffer);
+    if ((memory == nullptr) || (capacity < 0)) {
+        throw JniException("The given object is not a direct buffer");
+    }
+    return span<byte>(static_cast<byte *>(memory), static_cast<size_t>(capacity));
+}
+
+size_t JavaDirectBuffer::reclaim() {
+    auto env = JavaVirtualMachineRegistry::getEnvironment();
+    if (env == nullptr) {
+        return 0;
+    }
+
+    // A weak reference to a collected object is the same as a null reference.
+    lock_guard<mutex> lock(graveyardMutex);
+    auto collected = remove_if(graveyard.begin(), graveyard.end(), [env](auto &buried) {
+        if ((buried.first == nullptr) || !env->IsSameObject(buried.first, nullptr)) {
+            return false;
+        }
+        env->DeleteWeakGlobalRef(buried.first);
+        return true;
+    });
+    auto nbCollected = static_cast<size_t>(graveyard.end() - collected);
+    graveyard.erase(collected, graveyard.end());
+    return nbCollected;
+}
+
+JavaDirectBuffer::JavaDirectBuffer(JavaDirectBuffer &&other) noexcept :
+        buffer(other.buffer),
+        root(other.root),
+        address(other.address),
+        capacity(other.capacity),
+        owner(std::move(other.owner)) {
+    other.buffer = nullptr;
+    other.root = nullptr;
+    other.address = nullptr;
+    other.capacity = 0;
+}
+
+JavaDirectBuffer &JavaDirectBuffer::operator=(JavaDirectBuffer &&other) noexcept {
+    if (this != &other) {
+        release();
+        buffer = other.buffer;
+        root = other.root;
+        address = other.address;
+        capacity = other.capacity;
+        owner = std::move(other.owner);
+        other.buffer = nullptr;
+        other.root = nullptr;
+        other.address = nullptr;
+        other.capacity = 0;
+    }
+    return *this;
+}
+
+JavaDirectBuffer::~JavaDirectBuffer() {
+    release();
+}
+
+void JavaDirectBuffer::setByteOrder(ByteOrder order) {
+    if (order == ByteOrder::NATIVE) {
+        order = (endian::native == endian::little) ? ByteOrder::LITTLE : ByteOrder::BIG;
+    }
+
+    auto jvm = JavaVirtualMachineRegistry::get();
+    auto orderClass = jvm->loadClass("java/nio/ByteOrder");
+    auto field = orderClass.getStaticField<JByteOrder>((order == ByteOrder::LITTLE) ? "LITTLE_ENDIAN" : "BIG_ENDIAN");
+    auto byteOrder = field.getStatic(orderClass);
+
+    auto bufferClass = jvm->loadClass("java/nio/ByteBuffer");
+    auto method = bufferClass.getMethod<JByteBuffer(JByteOrder)>("order");
+    auto self = method.invoke(toObject(), byteOrder);
+
+    auto env = JavaVirtualMachineRegistry::getEnvironment();
+    env->DeleteLocalRef(*self);
+    env->DeleteLocalRef(*byteOrder);
+}
+
+JavaObject JavaDirectBuffer::asShortBuffer() {
+    return view("asShortBuffer", "java/nio/ShortBuffer");
+}
+
+JavaObject JavaDirectBuffer::asIntBuffer() {
+    return view("asIntBuffer", "java/nio/IntBuffer");
+}
+
+JavaObject JavaDirectBuffer::asLongBuffer() {
+    return view("asLongBuffer", "java/nio/LongBuffer");
+}
+
+JavaObject JavaDirectBuffer::asFloatBuffer() {
+    return view("asFloatBuffer", "java/nio/FloatBuffer");
+}
+
+JavaObject JavaDirectBuffer::asDoubleBuffer() {
+    return view("asDoubleBuffer", "java/nio/DoubleBuffer");
+}
+
+JavaObject JavaDirectBuffer::toObject() {
+    return JavaObject(buffer);
+}
+
+void JavaDirectBuffer::release() {
+    if (buffer == nullptr) {
+        return;
+    }
+
+    auto env = JavaVirtualMachineRegistry::getEnvironment();
+    if (env != nullptr) {
+        if (owner != nullptr) {
+            // Java code may still use the buffer: its memory must survive until it is collected.
+            reclaim();
+            lock_guard<mutex> lock(graveyardMutex);
+            graveyard.emplace_back(root, std::move(owner));
+        }
+        env->DeleteGlobalRef(buffer);
+    }
+
+    // Without a Java Virtual Machine, the memory cannot be used anymore.
+    buffer = nullptr;
+    root = nullptr;
+    owner = nullptr;
+}
+
+JavaObject JavaDirectBuffer::view(const char *method, const char *type) {
+    auto bufferClass = JavaVirtualMachineRegistry::get()->loadClass("java/nio/ByteBuffer");
+    auto viewMethod = bufferClass.getObjectMethod(method, string("()L") + type + ";");
+    return viewMethod.invoke(toObject());
+}
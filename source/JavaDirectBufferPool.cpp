@@ -0,0 +1,209 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#include <bit>
+#include <new>
+#include <string>
+
+#include "crillab-easyjni/JavaClass.h"
+#include "crillab-easyjni/JavaDirectBufferPool.h"
+#include "crillab-easyjni/JavaField.h"
+#include "crillab-easyjni/JavaSignature.h"
+#include "crillab-easyjni/JavaVirtualMachineRegistry.h"
+#include "crillab-easyjni/JniException.h"
+
+using namespace easyjni;
+using namespace std;
+
+/**
+ * The alignment of the arenas, which is that of a page on most systems.
+ */
+static constexpr size_t ARENA_ALIGNMENT = 4096;
+
+/**
+ * Releases the memory of an arena.
+ *
+ * @param arena The arena to release.
+ */
+static void deleteArena(byte *arena) {
+    ::operator delete[](arena, align_val_t(ARENA_ALIGNMENT));
+}
+
+JavaPooledBuffer::JavaPooledBuffer(shared_ptr<JavaDirectBufferPool::Shared> pool, JavaDirectBufferPool::Slot *slot,
+                                   size_t length) :
+        pool(std::move(pool)),
+        slot(slot),
+        length(length) {
+    // Nothing to do: everything is already initialized.
+}
+
+JavaPooledBuffer::JavaPooledBuffer(JavaPooledBuffer &&other) noexcept :
+        pool(std::move(other.pool)),
+        slot(other.slot),
+        length(other.length) {
+    // Nothing to do: the other buffer does not hold its slot anymore.
+}
+
+JavaPooledBuffer &JavaPooledBuffer::operator=(JavaPooledBuffer &&other) noexcept {
+    if (this != &other) {
+        if (pool != nullptr) {
+            pool->release(slot);
+        }
+        pool = std::move(other.pool);
+        slot = other.slot;
+        length = other.length;
+    }
+    return *this;
+}
+
+JavaPooledBuffer::~JavaPooledBuffer() {
+    if (pool != nullptr) {
+        pool->release(slot);
+    }
+}
+
+JavaDirectBufferPool::JavaDirectBufferPool(size_t budget, size_t arenaSize, size_t minSlotSize, ByteOrder order) :
+        arenaSize(arenaSize),
+        minSlotSize(minSlotSize),
+        order(order),
+        byteOrder(nullptr),
+        clearMethod(JavaVirtualMachineRegistry::get()->loadClass("java/nio/Buffer")
+                            .getMethod<JavaReference<"java/nio/Buffer">()>("clear")),
+        orderMethod(JavaVirtualMachineRegistry::get()->loadClass("java/nio/ByteBuffer")
+                            .getMethod<JavaReference<"java/nio/ByteBuffer">(
+                                    JavaReference<"java/nio/ByteOrder">)>("order")),
+        limitMethod(JavaVirtualMachineRegistry::get()->loadClass("java/nio/Buffer")
+                            .getMethod<JavaReference<"java/nio/Buffer">(jint)>("limit")),
+        shared(make_shared<Shared>()) {
+    if (!has_single_bit(arenaSize) || (arenaSize > JavaDirectBuffer::MAX_CAPACITY)
+        || !has_single_bit(minSlotSize) || (minSlotSize > arenaSize)) {
+        throw JniException("Invalid sizes for a pool of direct buffers");
+    }
+
+    // There is one size class for each power of two between the two sizes.
+    shared->sizeClasses.resize(bit_width(arenaSize) - bit_width(minSlotSize) + 1);
+    shared->statistics.budget = budget;
+
+    // Looking up the byte order given back to the buffers when they are reused.
+    bool little = (order == ByteOrder::LITTLE) || ((order == ByteOrder::NATIVE) && (endian::native == endian::little));
+    auto orderClass = JavaVirtualMachineRegistry::get()->loadClass("java/nio/ByteOrder");
+    auto field = orderClass.getStaticField<JavaReference<"java/nio/ByteOrder">>(little ? "LITTLE_ENDIAN" : "BIG_ENDIAN");
+    auto localOrder = field.getStatic(orderClass);
+    auto env = JavaVirtualMachineRegistry::getEnvironment();
+    byteOrder = env->NewGlobalRef(*localOrder);
+    env->DeleteLocalRef(*localOrder);
+}
+
+JavaDirectBufferPool::~JavaDirectBufferPool() {
+    // The slots are destroyed once the lent buffers have been given back.
+    auto env = JavaVirtualMachineRegistry::getEnvironment();
+    if (env != nullptr) {
+        env->DeleteGlobalRef(byteOrder);
+    }
+}
+
+JavaPooledBuffer JavaDirectBufferPool::acquire(size_t size) {
+    if (size > arenaSize) {
+        throw JniException("Cannot lend a buffer of " + to_string(size) + " bytes from a pool of direct buffers");
+    }
+    size_t classSize = bit_ceil(max(size, minSlotSize));
+    size_t index = bit_width(classSize) - bit_width(minSlotSize);
+
+    Slot *slot;
+    bool reused;
+    {
+        lock_guard<std::mutex> lock(shared->mutex);
+        reused = !shared->sizeClasses[index].available.empty();
+        slot = take(index);
+        shared->statistics.acquisitions++;
+        shared->statistics.usedBytes += classSize;
+        if (reused) {
+            shared->statistics.hits++;
+        }
+    }
+
+    JavaPooledBuffer lent(shared, slot, size);
+    auto context = JavaVirtualMachineRegistry::getContext();
+    auto env = context.getEnvironment();
+    if (reused) {
+        // The buffer may have been moved or reordered by its previous user.
+        auto cleared = clearMethod.invoke(context, lent.toObject());
+        env->DeleteLocalRef(*cleared);
+        auto ordered = orderMethod.invoke(context, lent.toObject(), byteOrder);
+        env->DeleteLocalRef(*ordered);
+    }
+
+    // Java code must not see more than the requested bytes, which may be left over by a previous user.
+    auto limited = limitMethod.invoke(context, lent.toObject(), static_cast<jint>(size));
+    env->DeleteLocalRef(*limited);
+    return lent;
+}
+
+JavaDirectBufferPool::Statistics JavaDirectBufferPool::getStatistics() const {
+    lock_guard<std::mutex> lock(shared->mutex);
+    return shared->statistics;
+}
+
+JavaDirectBufferPool::Slot *JavaDirectBufferPool::take(size_t index) {
+    auto &sizeClass = shared->sizeClasses[index];
+    if (!sizeClass.available.empty()) {
+        auto slot = sizeClass.available.back();
+        sizeClass.available.pop_back();
+        return slot;
+    }
+
+    // A new slot has to be carved, possibly from a new arena.
+    size_t classSize = minSlotSize << index;
+    if (shared->remaining < classSize) {
+        if (shared->statistics.reservedBytes + arenaSize > shared->statistics.budget) {
+            shared->statistics.rejections++;
+            throw JniException("The budget of the pool of direct buffers is exhausted");
+        }
+
+        // The rest of the current arena is split into smaller slots, which remain available.
+        while (shared->remaining >= minSlotSize) {
+            size_t rest = bit_width(bit_floor(shared->remaining)) - bit_width(minSlotSize);
+            shared->sizeClasses[rest].available.push_back(carve(rest));
+        }
+
+        shared->arena = Arena(static_cast<byte *>(::operator new[](arenaSize, align_val_t(ARENA_ALIGNMENT))),
+                              deleteArena);
+        shared->statistics.reservedBytes += arenaSize;
+        shared->next = shared->arena.get();
+        shared->remaining = arenaSize;
+    }
+    return carve(index);
+}
+
+JavaDirectBufferPool::Slot *JavaDirectBufferPool::carve(size_t index) {
+    // The Java buffer of the slot shares the ownership of the arena.
+    size_t classSize = minSlotSize << index;
+    JavaDirectBuffer buffer(shared->next, classSize, shared->arena, order);
+    shared->slots.push_back(make_unique<Slot>(Slot {std::move(buffer), index}));
+    shared->next += classSize;
+    shared->remaining -= classSize;
+    return shared->slots.back().get();
+}
+
+void JavaDirectBufferPool::Shared::release(Slot *slot) {
+    lock_guard<std::mutex> lock(mutex);
+    sizeClasses[slot->sizeClass].available.push_back(slot);
+    statistics.usedBytes -= slot->buffer.size();
+}
@@ -18,6 +18,10 @@
  * If not, see {@link http://www.gnu.org/licenses}.
  */
 
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_set>
+
 #include "crillab-easyjni/JavaElement.h"
 #include "crillab-easyjni/JavaObject.h"
 #include "crillab-easyjni/JavaVirtualMachineRegistry.h"
@@ -26,8 +30,20 @@
 using namespace easyjni;
 using namespace std;
 
+/**
+ * The names that have been interned so far.
+ * Elements of an unordered set are never moved, so the pointers to these
+ * names remain valid.
+ */
+static unordered_set<string> internedNames;
+
+/**
+ * The mutex used to avoid concurrent accesses to the interned names.
+ */
+static shared_mutex internedNamesMutex;
+
 JavaElement::JavaElement(string name) :
-        name(std::move(name)) {
+        name(intern(std::move(name))) {
     // Nothing to do: everything is already initialized.
 }
 
@@ -40,5 +56,19 @@ void JavaElement::checkException() {
 }
 
 const string &JavaElement::getName() const {
-    return name;
+    return *name;
+}
+
+const string *JavaElement::intern(string name) {
+    {
+        // Most names have already been interned.
+        shared_lock lock(internedNamesMutex);
+        auto it = internedNames.find(name);
+        if (it != internedNames.end()) {
+            return &*it;
+        }
+    }
+
+    unique_lock lock(internedNamesMutex);
+    return &*internedNames.insert(std::move(name)).first;
 }
@@ -0,0 +1,180 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#include "crillab-easyjni/JavaExecutor.h"
+#include "crillab-easyjni/JavaVirtualMachineRegistry.h"
+#include "crillab-easyjni/JniException.h"
+
+using namespace easyjni;
+using namespace std;
+
+/**
+ * The executor owning the current thread, if any.
+ */
+static thread_local const JavaExecutor *currentExecutor = nullptr;
+
+/**
+ * The index of the worker run by the current thread, if any.
+ */
+static thread_local size_t currentWorker = 0;
+
+JavaExecutor::JavaExecutor(unsigned int nbThreads) :
+        workers(),
+        threads(),
+        pending(0),
+        nextWorker(0),
+        stopping(false),
+        mutex(),
+        condition() {
+    if (JavaVirtualMachineRegistry::get() == nullptr) {
+        throw JniException("No Java Virtual Machine has been registered");
+    }
+
+    // Creating the workers.
+    size_t size = (nbThreads == 0) ? 1 : nbThreads;
+    vector<promise<void>> ready(size);
+    for (size_t i = 0; i < size; i++) {
+        workers.emplace_back(make_unique<Worker>());
+    }
+
+    // Starting the threads, and waiting for all of them to be attached.
+    for (size_t i = 0; i < size; i++) {
+        threads.emplace_back(&JavaExecutor::run, this, i, ref(ready[i]));
+    }
+    try {
+        for (auto &promise : ready) {
+            promise.get_future().get();
+        }
+
+    } catch (...) {
+        shutdown();
+        throw;
+    }
+}
+
+JavaExecutor::~JavaExecutor() {
+    shutdown();
+}
+
+void JavaExecutor::shutdown() {
+    {
+        lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+
+    for (auto &thread : threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+bool JavaExecutor::isWorkerThread() const {
+    return currentExecutor == this;
+}
+
+void JavaExecutor::schedule(function<void(const JavaContext &)> task) {
+    // Choosing the worker to which the task is assigned.
+    size_t index;
+    if (currentExecutor == this) {
+        index = currentWorker;
+    } else {
+        index = nextWorker.fetch_add(1, memory_order_relaxed) % workers.size();
+    }
+
+    // Adding the task to the queue of the worker.
+    pending.fetch_add(1);
+    {
+        lock_guard<std::mutex> lock(workers[index]->mutex);
+        workers[index]->tasks.push_back(std::move(task));
+    }
+
+    // Waking up an idle worker.
+    {
+        lock_guard<std::mutex> lock(mutex);
+    }
+    condition.notify_one();
+}
+
+void JavaExecutor::run(size_t index, promise<void> &ready) {
+    currentExecutor = this;
+    currentWorker = index;
+
+    // Attaching the thread to the JVM once for all.
+    // A failure must be reported to the constructor, as it would otherwise escape the thread.
+    JNIEnv *env;
+    try {
+        env = JavaVirtualMachineRegistry::getEnvironment();
+    } catch (...) {
+        ready.set_exception(current_exception());
+        return;
+    }
+    if (env == nullptr) {
+        ready.set_exception(make_exception_ptr(JniException("Could not attach thread to the JVM")));
+        return;
+    }
+    JavaContext context(env);
+    ready.set_value();
+
+    // Executing tasks until the executor is shut down.
+    function<void(const JavaContext &)> task;
+    for (;;) {
+        if (take(index, task)) {
+            task(context);
+            task = nullptr;
+            continue;
+        }
+
+        unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this] { return stopping || (pending.load() > 0); });
+        if (stopping && (pending.load() == 0)) {
+            break;
+        }
+    }
+
+    // The thread is not needed anymore.
+    JavaVirtualMachineRegistry::detachCurrentThread();
+}
+
+bool JavaExecutor::take(size_t index, function<void(const JavaContext &)> &task) {
+    for (size_t i = 0; i < workers.size(); i++) {
+        auto &worker = *workers[(index + i) % workers.size()];
+        lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.tasks.empty()) {
+            continue;
+        }
+
+        if (i == 0) {
+            // The worker takes the most recent of its own tasks.
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+
+        } else {
+            // The worker steals the oldest task of another worker.
+            task = std::move(worker.tasks.front());
+            worker.tasks.pop_front();
+        }
+
+        pending.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,134 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define EASYJNI_MMAP
+#endif
+
+#include "crillab-easyjni/JavaMappedFile.h"
+#include "crillab-easyjni/JniException.h"
+
+using namespace easyjni;
+using namespace std;
+
+#ifdef EASYJNI_MMAP
+
+/**
+ * Gives the size of the pages of the system.
+ *
+ * @return The size of the pages.
+ */
+static size_t pageSize() {
+    static const auto size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+/**
+ * Throws an exception describing the last error of a system call.
+ *
+ * @param message The message describing the operation that failed.
+ *
+ * @throws JniException Always.
+ */
+[[noreturn]] static void throwSystemError(const string &message) {
+    throw JniException(message + ": " + strerror(errno));
+}
+
+JavaDirectBuffer JavaMappedFile::map(
+        const string &path, MapMode mode, size_t offset, size_t length, bool hugePages, ByteOrder order) {
+    bool readOnly = (mode == MapMode::READ_ONLY);
+    // The descriptor must not leak into child processes spawned by other threads.
+    int fd = open(path.c_str(), (readOnly ? O_RDONLY : O_RDWR) | O_CLOEXEC);
+    if (fd < 0) {
+        throwSystemError("Could not open " + path);
+    }
+
+    // Computing the window to map.
+    struct stat status {};
+    if (fstat(fd, &status) < 0) {
+        close(fd);
+        throwSystemError("Could not get the size of " + path);
+    }
+    auto fileSize = static_cast<size_t>(status.st_size);
+    if (length == 0) {
+        length = (offset < fileSize) ? (fileSize - offset) : 0;
+    }
+    if ((length == 0) || (offset > fileSize) || (length > fileSize - offset)) {
+        close(fd);
+        throw JniException("Cannot map an empty window or a window out of the bounds of " + path);
+    }
+    if (length > JavaDirectBuffer::MAX_CAPACITY) {
+        close(fd);
+        throw JniException("Cannot map a window of more than 2 GiB of " + path);
+    }
+
+    // The mapping must start on a page, so the pages before the window are also mapped.
+    size_t start = offset - (offset % pageSize());
+    size_t mappedLength = length + (offset - start);
+    int protection = readOnly ? PROT_READ : (PROT_READ | PROT_WRITE);
+    void *base = mmap(nullptr, mappedLength, protection, MAP_SHARED, fd, static_cast<off_t>(start));
+    close(fd);
+    if (base == MAP_FAILED) {
+        throwSystemError("Could not map " + path);
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (hugePages) {
+        // Huge pages are best-effort: the mapping remains valid (with regular pages) on failure.
+        static_cast<void>(madvise(base, mappedLength, MADV_HUGEPAGE));
+    }
+#else
+    static_cast<void>(hugePages);
+#endif
+
+    shared_ptr<void> owner(base, [mappedLength](void *mapping) {
+        munmap(mapping, mappedLength);
+    });
+    return JavaDirectBuffer(static_cast<char *>(base) + (offset - start), length, std::move(owner), order, readOnly);
+}
+
+void JavaMappedFile::sync(const JavaDirectBuffer &buffer) {
+    auto address = reinterpret_cast<uintptr_t>(buffer.data());
+    auto start = address - (address % pageSize());
+    if (msync(reinterpret_cast<void *>(start), buffer.size() + (address - start), MS_SYNC) < 0) {
+        throwSystemError("Could not synchronize a mapped file");
+    }
+}
+
+#else
+
+JavaDirectBuffer JavaMappedFile::map(const string &, MapMode, size_t, size_t, bool, ByteOrder) {
+    throw JniException("Mapping files is not supported on this platform");
+}
+
+void JavaMappedFile::sync(const JavaDirectBuffer &) {
+    throw JniException("Mapping files is not supported on this platform");
+}
+
+#endif
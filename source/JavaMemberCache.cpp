@@ -0,0 +1,159 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#include <functional>
+
+#include "crillab-easyjni/JavaMemberCache.h"
+
+using namespace easyjni;
+using namespace std;
+
+atomic<JavaMemberCache::Entry *> JavaMemberCache::buckets[NB_BUCKETS];
+atomic<size_t> JavaMemberCache::nbEntries(0);
+atomic<unsigned long long> JavaMemberCache::hits(0);
+atomic<unsigned long long> JavaMemberCache::misses(0);
+vector<JavaMemberCache::Entry *> JavaMemberCache::retired;
+mutex JavaMemberCache::mutex;
+
+unsigned long long JavaMemberCache::getHits() {
+    return hits.load(memory_order_relaxed);
+}
+
+unsigned long long JavaMemberCache::getMisses() {
+    return misses.load(memory_order_relaxed);
+}
+
+size_t JavaMemberCache::size() {
+    return nbEntries.load(memory_order_relaxed);
+}
+
+void JavaMemberCache::clear() {
+    lock_guard<std::mutex> lock(mutex);
+    for (auto &bucket : buckets) {
+        // Concurrent lookups may still traverse the entries, which are thus retired.
+        for (auto entry = bucket.exchange(nullptr); entry != nullptr;
+                entry = entry->next.load(memory_order_relaxed)) {
+            retired.push_back(entry);
+        }
+    }
+    nbEntries = 0;
+    hits = 0;
+    misses = 0;
+}
+
+void JavaMemberCache::invalidate(string_view className) {
+    lock_guard<std::mutex> lock(mutex);
+    for (auto &bucket : buckets) {
+        // Removed entries keep their successor, so that concurrent lookups can go on.
+        auto link = &bucket;
+        for (auto entry = link->load(memory_order_relaxed); entry != nullptr;
+                entry = link->load(memory_order_relaxed)) {
+            if (entry->className == className) {
+                link->store(entry->next.load(memory_order_relaxed), memory_order_release);
+                retired.push_back(entry);
+                nbEntries.fetch_sub(1, memory_order_relaxed);
+
+            } else {
+                link = &entry->next;
+            }
+        }
+    }
+}
+
+void JavaMemberCache::reclaim(JNIEnv *env) {
+    lock_guard<std::mutex> lock(mutex);
+    for (auto entry : retired) {
+        env->DeleteWeakGlobalRef(entry->nativeClass);
+        delete entry;
+    }
+    retired.clear();
+}
+
+bool JavaMemberCache::isNamed(string_view className) {
+    // Classes with an unknown name (e.g., the class of an object) have a placeholder name.
+    return !className.empty() && (className.front() != '<');
+}
+
+size_t JavaMemberCache::hash(Kind kind, string_view name, string_view signature) {
+    std::hash<string_view> hasher;
+    size_t h = static_cast<size_t>(kind);
+    for (auto part : {name, signature}) {
+        h ^= hasher(part) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    }
+    return h;
+}
+
+void *JavaMemberCache::find(JNIEnv *env, Kind kind, jclass nativeClass, string_view className,
+                            string_view name, string_view signature) {
+    auto h = hash(kind, name, signature);
+    auto head = buckets[h % NB_BUCKETS].load(memory_order_acquire);
+    auto entry = findEntry(env, head, h, kind, nativeClass, className, name, signature);
+    if (entry == nullptr) {
+        misses.fetch_add(1, memory_order_relaxed);
+        return nullptr;
+    }
+
+    hits.fetch_add(1, memory_order_relaxed);
+    return entry->id;
+}
+
+void JavaMemberCache::insert(JNIEnv *env, Kind kind, jclass nativeClass, string_view className,
+                             string_view name, string_view signature, void *id) {
+    auto h = hash(kind, name, signature);
+    auto &bucket = buckets[h % NB_BUCKETS];
+    lock_guard<std::mutex> lock(mutex);
+
+    // Checking that the member has not been inserted in the meantime.
+    auto head = bucket.load(memory_order_acquire);
+    if (findEntry(env, head, h, kind, nativeClass, className, name, signature) != nullptr) {
+        return;
+    }
+
+    // The member cannot be cached if its class cannot be referenced.
+    jweak weakClass = env->NewWeakGlobalRef(nativeClass);
+    if (weakClass == nullptr) {
+        env->ExceptionClear();
+        return;
+    }
+
+    // Publishing the new entry at the head of its bucket.
+    auto entry = new Entry {h, kind, string(className), weakClass, string(name), string(signature), id, head};
+    bucket.store(entry, memory_order_release);
+    nbEntries.fetch_add(1, memory_order_relaxed);
+}
+
+JavaMemberCache::Entry *JavaMemberCache::findEntry(JNIEnv *env, Entry *head, size_t h, Kind kind, jclass nativeClass,
+                                                   string_view className, string_view name, string_view signature) {
+    bool named = isNamed(className);
+    for (auto entry = head; entry != nullptr; entry = entry->next.load(memory_order_acquire)) {
+        if ((entry->hash != h) || (entry->kind != kind) || (entry->name != name) || (entry->signature != signature)) {
+            continue;
+        }
+
+        // Classes with different known names cannot be the same, whatever their loader.
+        if (named && isNamed(entry->className) && (entry->className != className)) {
+            continue;
+        }
+        if (env->IsSameObject(entry->nativeClass, nativeClass)) {
+            return entry;
+        }
+    }
+    return nullptr;
+}
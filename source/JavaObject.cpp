@@ -18,14 +18,94 @@
  * If not, see {@link http://www.gnu.org/licenses}.
  */
 
+#include <atomic>
+#include <mutex>
+
 #include "crillab-easyjni/JavaClass.h"
-#include "crillab-easyjni/JavaMethod.h"
+#include "crillab-easyjni/JavaContext.h"
 #include "crillab-easyjni/JavaObject.h"
 #include "crillab-easyjni/JavaVirtualMachineRegistry.h"
+#include "crillab-easyjni/JniException.h"
 
 using namespace easyjni;
 using namespace std;
 
+/**
+ * The ObjectMethods stores the native identifiers of the methods declared by
+ * java.lang.Object that are invoked from JavaObject.
+ * Invoking these methods through their declaration in java.lang.Object still
+ * dispatches to the implementation of the runtime class of the receiver.
+ */
+struct ObjectMethods {
+
+    /**
+     * The method toString().
+     */
+    jmethodID toString;
+
+    /**
+     * The method hashCode().
+     */
+    jmethodID hashCode;
+
+    /**
+     * The method equals(Object).
+     */
+    jmethodID equals;
+
+};
+
+/**
+ * The methods declared by java.lang.Object.
+ */
+static ObjectMethods objectMethods;
+
+/**
+ * Whether the methods declared by java.lang.Object have been resolved.
+ */
+static atomic<bool> objectMethodsResolved(false);
+
+/**
+ * The mutex used to resolve the methods declared by java.lang.Object only once.
+ */
+static mutex objectMethodsMutex;
+
+/**
+ * Gives the methods declared by java.lang.Object, resolving them if needed.
+ *
+ * @param env The native Java Environment provided by JNI.
+ *
+ * @return The methods declared by java.lang.Object.
+ *
+ * @throws JniException If the methods cannot be resolved.
+ */
+static const ObjectMethods &getObjectMethods(JNIEnv *env) {
+    if (objectMethodsResolved.load(memory_order_acquire)) {
+        return objectMethods;
+    }
+
+    lock_guard<mutex> lock(objectMethodsMutex);
+    if (!objectMethodsResolved.load(memory_order_relaxed)) {
+        jclass objectClass = env->FindClass("java/lang/Object");
+        if (objectClass == nullptr) {
+            JavaContext(env).checkException();
+            throw JniException("Could not load class java/lang/Object");
+        }
+
+        objectMethods.toString = env->GetMethodID(objectClass, "toString", METHOD(CLASS(java/lang/String)));
+        objectMethods.hashCode = env->GetMethodID(objectClass, "hashCode", METHOD(INTEGER));
+        objectMethods.equals = env->GetMethodID(objectClass, "equals", METHOD(BOOLEAN, CLASS(java/lang/Object)));
+        env->DeleteLocalRef(objectClass);
+        if ((objectMethods.toString == nullptr) || (objectMethods.hashCode == nullptr)
+                || (objectMethods.equals == nullptr)) {
+            JavaContext(env).checkException();
+            throw JniException("Could not find the methods of class java/lang/Object");
+        }
+        objectMethodsResolved.store(true, memory_order_release);
+    }
+    return objectMethods;
+}
+
 JavaObject::JavaObject(jobject nativeObject) :
         nativeObject(nativeObject) {
     // Nothing to do: everything is already initialized.
@@ -48,31 +128,37 @@ JavaClass JavaObject::getClass() {
 }
 
 int JavaObject::hashCode() {
-    auto metaClass = getClass();
-    auto method = metaClass.getIntMethod("hashCode");
-    return method.invoke(*this);
+    auto env = JavaVirtualMachineRegistry::getEnvironment();
+    auto hashCode = env->CallIntMethod(nativeObject, getObjectMethods(env).hashCode);
+    JavaContext(env).checkException();
+    return hashCode;
 }
 
 bool JavaObject::equals(JavaObject &other) {
-    auto metaClass = getClass();
-    auto method = metaClass.getBooleanMethod("equals", METHOD(BOOLEAN, CLASS(java/lang/Object)));
-    return method.invoke(*this, *other);
+    auto env = JavaVirtualMachineRegistry::getEnvironment();
+    auto equals = env->CallBooleanMethod(nativeObject, getObjectMethods(env).equals, other.nativeObject);
+    JavaContext(env).checkException();
+    return equals;
 }
 
 string JavaObject::toString() {
     // Invoking the toString() method on the Java object.
-    auto metaClass = getClass();
-    auto method = metaClass.getObjectMethod("toString", METHOD(CLASS(java/lang/String)));
-    auto str = method.invoke(*this);
-    auto javaString = (jstring) str.nativeObject;
+    auto env = JavaVirtualMachineRegistry::getEnvironment();
+    auto javaString = (jstring) env->CallObjectMethod(nativeObject, getObjectMethods(env).toString);
+    JavaContext(env).checkException();
+    if (javaString == nullptr) {
+        return "null";
+    }
 
     // Copying the Java string into a C++ string.
-    const char *nativeString = JavaVirtualMachineRegistry::getEnvironment()->GetStringUTFChars(javaString, nullptr);
-    JavaVirtualMachineRegistry::get()->checkException();
+    const char *nativeString = env->GetStringUTFChars(javaString, nullptr);
+    if (nativeString == nullptr) {
+        env->DeleteLocalRef(javaString);
+        JavaContext(env).checkException();
+        throw JniException("Could not read the string representation of an object");
+    }
     string cppString(nativeString);
-    JavaVirtualMachineRegistry::getEnvironment()->ReleaseStringUTFChars(javaString, nativeString);
-    JavaVirtualMachineRegistry::get()->checkException();
+    env->ReleaseStringUTFChars(javaString, nativeString);
+    env->DeleteLocalRef(javaString);
     return cppString;
 }
-
-
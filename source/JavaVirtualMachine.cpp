@@ -18,14 +18,242 @@
  * If not, see {@link http://www.gnu.org/licenses}.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+
 #include "crillab-easyjni/JavaArray.h"
-#include "crillab-easyjni/JavaMethod.h"
+#include "crillab-easyjni/JavaContext.h"
+#include "crillab-easyjni/JavaMemberCache.h"
 #include "crillab-easyjni/JavaVirtualMachine.h"
 #include "crillab-easyjni/JniException.h"
 
 using namespace easyjni;
 using namespace std;
 
+unordered_map<string, jclass> JavaVirtualMachine::classCache;
+size_t JavaVirtualMachine::classCacheCapacity = 4096;
+vector<jclass> JavaVirtualMachine::retiredClasses;
+shared_mutex JavaVirtualMachine::classCacheMutex;
+
+/**
+ * The BoxedType stores the native identifiers needed to wrap and unwrap
+ * the values of a primitive type.
+ */
+struct BoxedType {
+
+    /**
+     * The (global reference to the) class wrapping the primitive type.
+     */
+    jclass clazz;
+
+    /**
+     * The static method valueOf() of the wrapper class.
+     */
+    jmethodID valueOf;
+
+    /**
+     * The method giving the primitive value of a wrapped value.
+     */
+    jmethodID unwrap;
+
+};
+
+/**
+ * The Boxing stores the native identifiers of all wrapper classes, together
+ * with the global references to the objects wrapping small values, which are
+ * created the first time they are needed.
+ */
+struct Boxing {
+
+    BoxedType booleanType;
+    BoxedType byteType;
+    BoxedType charType;
+    BoxedType shortType;
+    BoxedType intType;
+    BoxedType longType;
+    BoxedType floatType;
+    BoxedType doubleType;
+
+    atomic<jobject> booleanValues[2];
+    atomic<jobject> byteValues[256];
+    atomic<jobject> charValues[128];
+    atomic<jobject> shortValues[256];
+    atomic<jobject> intValues[256];
+    atomic<jobject> longValues[256];
+
+};
+
+/**
+ * The boxing data of the Java Virtual Machine, resolved the first time it is needed.
+ */
+static atomic<Boxing *> boxingData(nullptr);
+
+/**
+ * The mutex used to resolve the boxing data only once.
+ */
+static mutex boxingMutex;
+
+/**
+ * Resolves the native identifiers needed to wrap and unwrap the values of a
+ * primitive type.
+ *
+ * @param env The native Java Environment provided by JNI.
+ * @param className The name of the wrapper class.
+ * @param valueOfSignature The signature of the method valueOf() in the wrapper class.
+ * @param unwrapClassName The name of the class declaring the unwrapping method.
+ * @param unwrapName The name of the unwrapping method.
+ * @param unwrapSignature The signature of the unwrapping method.
+ *
+ * @return The resolved identifiers.
+ *
+ * @throws JniException If the identifiers cannot be resolved.
+ */
+static BoxedType resolveBoxedType(JNIEnv *env, const char *className, const char *valueOfSignature,
+                                  const char *unwrapClassName, const char *unwrapName, const char *unwrapSignature) {
+    BoxedType type {};
+    jclass localClass = env->FindClass(className);
+    jclass unwrapClass = env->FindClass(unwrapClassName);
+    if ((localClass == nullptr) || (unwrapClass == nullptr)) {
+        JavaContext(env).checkException();
+        throw JniException(string("Could not load class ") + className);
+    }
+
+    type.clazz = (jclass) env->NewGlobalRef(localClass);
+    type.valueOf = env->GetStaticMethodID(localClass, "valueOf", valueOfSignature);
+    type.unwrap = env->GetMethodID(unwrapClass, unwrapName, unwrapSignature);
+    env->DeleteLocalRef(localClass);
+    env->DeleteLocalRef(unwrapClass);
+    if ((type.valueOf == nullptr) || (type.unwrap == nullptr)) {
+        env->DeleteGlobalRef(type.clazz);
+        JavaContext(env).checkException();
+        throw JniException(string("Could not find boxing methods for class ") + className);
+    }
+    return type;
+}
+
+/**
+ * Gives the boxing data of the Java Virtual Machine, resolving it if needed.
+ *
+ * @param env The native Java Environment provided by JNI.
+ *
+ * @return The boxing data.
+ *
+ * @throws JniException If the boxing data cannot be resolved.
+ */
+static Boxing &getBoxing(JNIEnv *env) {
+    auto boxing = boxingData.load(memory_order_acquire);
+    if (boxing != nullptr) {
+        return *boxing;
+    }
+
+    lock_guard<mutex> lock(boxingMutex);
+    boxing = boxingData.load(memory_order_acquire);
+    if (boxing == nullptr) {
+        auto newBoxing = make_unique<Boxing>();
+        newBoxing->booleanType = resolveBoxedType(env, "java/lang/Boolean",
+                METHOD(CLASS(java/lang/Boolean), BOOLEAN), "java/lang/Boolean", "booleanValue", METHOD(BOOLEAN));
+        newBoxing->byteType = resolveBoxedType(env, "java/lang/Byte",
+                METHOD(CLASS(java/lang/Byte), BYTE), "java/lang/Number", "byteValue", METHOD(BYTE));
+        newBoxing->charType = resolveBoxedType(env, "java/lang/Character",
+                METHOD(CLASS(java/lang/Character), CHARACTER), "java/lang/Character", "charValue", METHOD(CHARACTER));
+        newBoxing->shortType = resolveBoxedType(env, "java/lang/Short",
+                METHOD(CLASS(java/lang/Short), SHORT), "java/lang/Number", "shortValue", METHOD(SHORT));
+        newBoxing->intType = resolveBoxedType(env, "java/lang/Integer",
+                METHOD(CLASS(java/lang/Integer), INTEGER), "java/lang/Number", "intValue", METHOD(INTEGER));
+        newBoxing->longType = resolveBoxedType(env, "java/lang/Long",
+                METHOD(CLASS(java/lang/Long), LONG), "java/lang/Number", "longValue", METHOD(LONG));
+        newBoxing->floatType = resolveBoxedType(env, "java/lang/Float",
+                METHOD(CLASS(java/lang/Float), FLOAT), "java/lang/Number", "floatValue", METHOD(FLOAT));
+        newBoxing->doubleType = resolveBoxedType(env, "java/lang/Double",
+                METHOD(CLASS(java/lang/Double), DOUBLE), "java/lang/Number", "doubleValue", METHOD(DOUBLE));
+        boxing = newBoxing.release();
+        boxingData.store(boxing, memory_order_release);
+    }
+    return *boxing;
+}
+
+/**
+ * Releases the boxing data of the Java Virtual Machine, if it has been resolved.
+ *
+ * @param env The native Java Environment provided by JNI.
+ */
+static void releaseBoxing(JNIEnv *env) {
+    lock_guard<mutex> lock(boxingMutex);
+    unique_ptr<Boxing> boxing(boxingData.exchange(nullptr));
+    if (boxing == nullptr) {
+        return;
+    }
+
+    for (auto type : {&boxing->booleanType, &boxing->byteType, &boxing->charType, &boxing->shortType,
+                      &boxing->intType, &boxing->longType, &boxing->floatType, &boxing->doubleType}) {
+        env->DeleteGlobalRef(type->clazz);
+    }
+
+    for (auto values : {span<atomic<jobject>>(boxing->booleanValues), span<atomic<jobject>>(boxing->byteValues),
+                        span<atomic<jobject>>(boxing->charValues), span<atomic<jobject>>(boxing->shortValues),
+                        span<atomic<jobject>>(boxing->intValues), span<atomic<jobject>>(boxing->longValues)}) {
+        for (auto &value : values) {
+            if (value.load() != nullptr) {
+                env->DeleteGlobalRef(value.load());
+            }
+        }
+    }
+}
+
+/**
+ * Wraps a primitive value into an object.
+ *
+ * @param env The native Java Environment provided by JNI.
+ * @param type The identifiers of the wrapper type.
+ * @param value The value to wrap.
+ *
+ * @return The (local reference to the) wrapped value.
+ *
+ * @throws JniException If an error occurred while wrapping the value.
+ */
+static jobject box(JNIEnv *env, const BoxedType &type, jvalue value) {
+    jobject object = env->CallStaticObjectMethodA(type.clazz, type.valueOf, &value);
+    JavaContext(env).checkException();
+    return object;
+}
+
+/**
+ * Wraps a small primitive value into an object, which is cached as a global reference.
+ *
+ * @param env The native Java Environment provided by JNI.
+ * @param cached The slot in which the wrapped value is cached.
+ * @param type The identifiers of the wrapper type.
+ * @param value The value to wrap.
+ *
+ * @return A new local reference to the wrapped value.
+ *
+ * @throws JniException If an error occurred while wrapping the value.
+ */
+static jobject boxCached(JNIEnv *env, atomic<jobject> &cached, const BoxedType &type, jvalue value) {
+    jobject object = cached.load(memory_order_acquire);
+    if (object == nullptr) {
+        // The value is wrapped for the first time.
+        jobject local = box(env, type, value);
+        jobject global = env->NewGlobalRef(local);
+        env->DeleteLocalRef(local);
+
+        // Another thread may have wrapped the same value in the meantime.
+        object = nullptr;
+        if (cached.compare_exchange_strong(object, global, memory_order_acq_rel)) {
+            object = global;
+        } else {
+            env->DeleteGlobalRef(global);
+        }
+    }
+
+    // Callers may delete the returned reference, which must not be the cached one.
+    return env->NewLocalRef(object);
+}
+
 JavaVirtualMachine::JavaVirtualMachine(JavaVM *jvm, JNIEnv *env, bool main) :
         jvm(jvm),
         env(env),
@@ -35,6 +263,11 @@ JavaVirtualMachine::JavaVirtualMachine(JavaVM *jvm, JNIEnv *env, bool main) :
 
 JavaVirtualMachine::~JavaVirtualMachine() {
     if (main) {
+        invalidateClassCache();
+        reclaimInvalidatedClasses();
+        JavaMemberCache::reclaim(env);
+        JavaClass::clearMetadataCache(env);
+        releaseBoxing(env);
         jvm->DestroyJavaVM();
     }
 }
@@ -47,117 +280,185 @@ pair<int, int> JavaVirtualMachine::getVersion() {
 }
 
 void JavaVirtualMachine::checkException() {
-    if (env->ExceptionCheck()) {
-        JavaObject except(env->ExceptionOccurred());
-        env->ExceptionClear();
-        throw JniException(except.toString());
-    }
+    JavaContext(env).checkException();
 }
 
 JavaClass JavaVirtualMachine::loadClass(const string &name) {
-    jclass nativeClass = env->FindClass(name.c_str());
-    if (nativeClass == nullptr) {
+    // Looking for the class in the cache.
+    {
+        shared_lock<shared_mutex> lock(classCacheMutex);
+        auto cached = classCache.find(name);
+        if (cached != classCache.end()) {
+            return JavaClass(name, cached->second);
+        }
+    }
+
+    // The class has to be loaded.
+    jclass localClass = env->FindClass(name.c_str());
+    if (localClass == nullptr) {
         checkException();
         throw JniException("Could not load class " + name);
     }
-    nativeClass = (jclass) env->NewGlobalRef(nativeClass);
+
+    // Storing the class in the cache, unless another thread did it in the meantime.
+    unique_lock<shared_mutex> lock(classCacheMutex);
+    auto cached = classCache.find(name);
+    if (cached != classCache.end()) {
+        env->DeleteLocalRef(localClass);
+        return JavaClass(name, cached->second);
+    }
+    auto nativeClass = (jclass) env->NewGlobalRef(localClass);
+    env->DeleteLocalRef(localClass);
+    if (classCacheCapacity == 0) {
+        // Nothing can be cached: the reference is retired right away.
+        retiredClasses.push_back(nativeClass);
+        return JavaClass(name, nativeClass);
+    }
+
+    // When the cache is full, arbitrary classes are evicted, but their references remain valid.
+    while (classCache.size() >= classCacheCapacity) {
+        auto evicted = classCache.begin();
+        retiredClasses.push_back(evicted->second);
+        JavaMemberCache::invalidate(evicted->first);
+        classCache.erase(evicted);
+    }
+    classCache.emplace(name, nativeClass);
     return JavaClass(name, nativeClass);
 }
 
+void JavaVirtualMachine::invalidateClass(const string &name) {
+    unique_lock<shared_mutex> lock(classCacheMutex);
+    auto cached = classCache.find(name);
+    if (cached != classCache.end()) {
+        retiredClasses.push_back(cached->second);
+        classCache.erase(cached);
+    }
+    JavaMemberCache::invalidate(name);
+}
+
+void JavaVirtualMachine::invalidateClassCache() {
+    unique_lock<shared_mutex> lock(classCacheMutex);
+    for (auto &cached : classCache) {
+        retiredClasses.push_back(cached.second);
+    }
+    classCache.clear();
+    JavaMemberCache::clear();
+}
+
+void JavaVirtualMachine::reclaimInvalidatedClasses() {
+    unique_lock<shared_mutex> lock(classCacheMutex);
+    for (auto nativeClass : retiredClasses) {
+        env->DeleteGlobalRef(nativeClass);
+    }
+    retiredClasses.clear();
+}
+
+size_t JavaVirtualMachine::getClassCacheSize() {
+    shared_lock<shared_mutex> lock(classCacheMutex);
+    return classCache.size();
+}
+
+void JavaVirtualMachine::setClassCacheCapacity(size_t capacity) {
+    unique_lock<shared_mutex> lock(classCacheMutex);
+    classCacheCapacity = capacity;
+}
+
 JavaObject JavaVirtualMachine::wrap(jboolean b) {
-    auto cls = loadClass("java/lang/Boolean");
-    auto mtd = cls.getStaticObjectMethod("valueOf", METHOD(CLASS(java/lang/Boolean), BOOLEAN));
-    return mtd.invokeStatic(cls, b);
+    auto &boxing = getBoxing(env);
+    return JavaObject(boxCached(env, boxing.booleanValues[b ? 1 : 0], boxing.booleanType, jvalue {.z = b}));
 }
 
 JavaObject JavaVirtualMachine::wrap(jbyte b) {
-    auto cls = loadClass("java/lang/Byte");
-    auto mtd = cls.getStaticObjectMethod("valueOf", METHOD(CLASS(java/lang/Byte), BYTE));
-    return mtd.invokeStatic(cls, b);
+    auto &boxing = getBoxing(env);
+    return JavaObject(boxCached(env, boxing.byteValues[b + 128], boxing.byteType, jvalue {.b = b}));
 }
 
 JavaObject JavaVirtualMachine::wrap(jchar c) {
-    auto cls = loadClass("java/lang/Character");
-    auto mtd = cls.getStaticObjectMethod("valueOf", METHOD(CLASS(java/lang/Character), CHARACTER));
-    return mtd.invokeStatic(cls, c);
+    auto &boxing = getBoxing(env);
+    if (c < 128) {
+        return JavaObject(boxCached(env, boxing.charValues[c], boxing.charType, jvalue {.c = c}));
+    }
+    return JavaObject(box(env, boxing.charType, jvalue {.c = c}));
 }
 
 JavaObject JavaVirtualMachine::wrap(jshort s) {
-    auto cls = loadClass("java/lang/Short");
-    auto mtd = cls.getStaticObjectMethod("valueOf", METHOD(CLASS(java/lang/Short), SHORT));
-    return mtd.invokeStatic(cls, s);
+    auto &boxing = getBoxing(env);
+    if ((s >= -128) && (s <= 127)) {
+        return JavaObject(boxCached(env, boxing.shortValues[s + 128], boxing.shortType, jvalue {.s = s}));
+    }
+    return JavaObject(box(env, boxing.shortType, jvalue {.s = s}));
 }
 
 JavaObject JavaVirtualMachine::wrap(jint i) {
-    auto cls = loadClass("java/lang/Integer");
-    auto mtd = cls.getStaticObjectMethod("valueOf", METHOD(CLASS(java/lang/Integer), INTEGER));
-    return mtd.invokeStatic(cls, i);
+    auto &boxing = getBoxing(env);
+    if ((i >= -128) && (i <= 127)) {
+        return JavaObject(boxCached(env, boxing.intValues[i + 128], boxing.intType, jvalue {.i = i}));
+    }
+    return JavaObject(box(env, boxing.intType, jvalue {.i = i}));
 }
 
 JavaObject JavaVirtualMachine::wrap(jlong l) {
-    auto cls = loadClass("java/lang/Long");
-    auto mtd = cls.getStaticObjectMethod("valueOf", METHOD(CLASS(java/lang/Long), LONG));
-    return mtd.invokeStatic(cls, l);
+    auto &boxing = getBoxing(env);
+    if ((l >= -128) && (l <= 127)) {
+        return JavaObject(boxCached(env, boxing.longValues[l + 128], boxing.longType, jvalue {.j = l}));
+    }
+    return JavaObject(box(env, boxing.longType, jvalue {.j = l}));
 }
 
 JavaObject JavaVirtualMachine::wrap(jfloat f) {
-    auto cls = loadClass("java/lang/Float");
-    auto mtd = cls.getStaticObjectMethod("valueOf", METHOD(CLASS(java/lang/Float), FLOAT));
-    return mtd.invokeStatic(cls, f);
+    return JavaObject(box(env, getBoxing(env).floatType, jvalue {.f = f}));
 }
 
 JavaObject JavaVirtualMachine::wrap(jdouble d) {
-    auto cls = loadClass("java/lang/Double");
-    auto mtd = cls.getStaticObjectMethod("valueOf", METHOD(CLASS(java/lang/Double), DOUBLE));
-    return mtd.invokeStatic(cls, d);
+    return JavaObject(box(env, getBoxing(env).doubleType, jvalue {.d = d}));
 }
 
 jboolean JavaVirtualMachine::unwrapAsBoolean(const JavaObject &b) {
-    auto cls = loadClass("java/lang/Boolean");
-    auto mtd = cls.getBooleanMethod("booleanValue");
-    return mtd.invoke(b);
+    auto value = env->CallBooleanMethod(b.nativeObject, getBoxing(env).booleanType.unwrap);
+    checkException();
+    return value;
 }
 
 jbyte JavaVirtualMachine::unwrapAsByte(const JavaObject &b) {
-    auto cls = loadClass("java/lang/Number");
-    auto mtd = cls.getByteMethod("byteValue");
-    return mtd.invoke(b);
+    auto value = env->CallByteMethod(b.nativeObject, getBoxing(env).byteType.unwrap);
+    checkException();
+    return value;
 }
 
 jchar JavaVirtualMachine::unwrapAsChar(const JavaObject &c) {
-    auto cls = loadClass("java/lang/Character");
-    auto mtd = cls.getCharMethod("charValue");
-    return mtd.invoke(c);
+    auto value = env->CallCharMethod(c.nativeObject, getBoxing(env).charType.unwrap);
+    checkException();
+    return value;
 }
 
 jshort JavaVirtualMachine::unwrapAsShort(const JavaObject &s) {
-    auto cls = loadClass("java/lang/Number");
-    auto mtd = cls.getShortMethod("shortValue");
-    return mtd.invoke(s);
+    auto value = env->CallShortMethod(s.nativeObject, getBoxing(env).shortType.unwrap);
+    checkException();
+    return value;
 }
 
 jint JavaVirtualMachine::unwrapAsInt(const JavaObject &i) {
-    auto cls = loadClass("java/lang/Number");
-    auto mtd = cls.getIntMethod("intValue");
-    return mtd.invoke(i);
+    auto value = env->CallIntMethod(i.nativeObject, getBoxing(env).intType.unwrap);
+    checkException();
+    return value;
 }
 
 jlong JavaVirtualMachine::unwrapAsLong(const JavaObject &l) {
-    auto cls = loadClass("java/lang/Number");
-    auto mtd = cls.getLongMethod("longValue");
-    return mtd.invoke(l);
+    auto value = env->CallLongMethod(l.nativeObject, getBoxing(env).longType.unwrap);
+    checkException();
+    return value;
 }
 
 jfloat JavaVirtualMachine::unwrapAsFloat(const JavaObject &f) {
-    auto cls = loadClass("java/lang/Number");
-    auto mtd = cls.getFloatMethod("floatValue");
-    return mtd.invoke(f);
+    auto value = env->CallFloatMethod(f.nativeObject, getBoxing(env).floatType.unwrap);
+    checkException();
+    return value;
 }
 
 jdouble JavaVirtualMachine::unwrapAsDouble(const JavaObject &d) {
-    auto cls = loadClass("java/lang/Number");
-    auto mtd = cls.getDoubleMethod("doubleValue");
-    return mtd.invoke(d);
+    auto value = env->CallDoubleMethod(d.nativeObject, getBoxing(env).doubleType.unwrap);
+    checkException();
+    return value;
 }
 
 JavaObject JavaVirtualMachine::toJavaString(const string &str) {
@@ -176,50 +477,153 @@ JavaArray<jboolean> JavaVirtualMachine::createBooleanArray(int size) {
     return JavaArray<jboolean>(array);
 }
 
+JavaArray<jboolean> JavaVirtualMachine::createBooleanArray(span<const jboolean> elements) {
+    auto array = env->NewBooleanArray((jsize) elements.size());
+    checkException();
+    env->SetBooleanArrayRegion(array, 0, (jsize) elements.size(), elements.data());
+    checkException();
+    return JavaArray<jboolean>(array);
+}
+
 JavaArray<jbyte> JavaVirtualMachine::createByteArray(int size) {
     auto array = env->NewByteArray(size);
     checkException();
     return JavaArray<jbyte>(array);
 }
 
+JavaArray<jbyte> JavaVirtualMachine::createByteArray(span<const jbyte> elements) {
+    auto array = env->NewByteArray((jsize) elements.size());
+    checkException();
+    env->SetByteArrayRegion(array, 0, (jsize) elements.size(), elements.data());
+    checkException();
+    return JavaArray<jbyte>(array);
+}
+
 JavaArray<jchar> JavaVirtualMachine::createCharArray(int size) {
     auto array = env->NewCharArray(size);
     checkException();
     return JavaArray<jchar>(array);
 }
 
+JavaArray<jchar> JavaVirtualMachine::createCharArray(span<const jchar> elements) {
+    auto array = env->NewCharArray((jsize) elements.size());
+    checkException();
+    env->SetCharArrayRegion(array, 0, (jsize) elements.size(), elements.data());
+    checkException();
+    return JavaArray<jchar>(array);
+}
+
 JavaArray<jshort> JavaVirtualMachine::createShortArray(int size) {
     auto array = env->NewShortArray(size);
     checkException();
     return JavaArray<jshort>(array);
 }
 
+JavaArray<jshort> JavaVirtualMachine::createShortArray(span<const jshort> elements) {
+    auto array = env->NewShortArray((jsize) elements.size());
+    checkException();
+    env->SetShortArrayRegion(array, 0, (jsize) elements.size(), elements.data());
+    checkException();
+    return JavaArray<jshort>(array);
+}
+
 JavaArray<jint> JavaVirtualMachine::createIntArray(int size) {
     auto array = env->NewIntArray(size);
     checkException();
     return JavaArray<jint>(array);
 }
 
+JavaArray<jint> JavaVirtualMachine::createIntArray(span<const jint> elements) {
+    auto array = env->NewIntArray((jsize) elements.size());
+    checkException();
+    env->SetIntArrayRegion(array, 0, (jsize) elements.size(), elements.data());
+    checkException();
+    return JavaArray<jint>(array);
+}
+
 JavaArray<jlong> JavaVirtualMachine::createLongArray(int size) {
     auto array = env->NewLongArray(size);
     checkException();
     return JavaArray<jlong>(array);
 }
 
+JavaArray<jlong> JavaVirtualMachine::createLongArray(span<const jlong> elements) {
+    auto array = env->NewLongArray((jsize) elements.size());
+    checkException();
+    env->SetLongArrayRegion(array, 0, (jsize) elements.size(), elements.data());
+    checkException();
+    return JavaArray<jlong>(array);
+}
+
 JavaArray<jfloat> JavaVirtualMachine::createFloatArray(int size) {
     auto array = env->NewFloatArray(size);
     checkException();
     return JavaArray<jfloat>(array);
 }
 
+JavaArray<jfloat> JavaVirtualMachine::createFloatArray(span<const jfloat> elements) {
+    auto array = env->NewFloatArray((jsize) elements.size());
+    checkException();
+    env->SetFloatArrayRegion(array, 0, (jsize) elements.size(), elements.data());
+    checkException();
+    return JavaArray<jfloat>(array);
+}
+
 JavaArray<jdouble> JavaVirtualMachine::createDoubleArray(int size) {
     auto array = env->NewDoubleArray(size);
     checkException();
     return JavaArray<jdouble>(array);
 }
 
+JavaArray<jdouble> JavaVirtualMachine::createDoubleArray(span<const jdouble> elements) {
+    auto array = env->NewDoubleArray((jsize) elements.size());
+    checkException();
+    env->SetDoubleArrayRegion(array, 0, (jsize) elements.size(), elements.data());
+    checkException();
+    return JavaArray<jdouble>(array);
+}
+
 JavaArray<JavaObject> JavaVirtualMachine::createObjectArray(int size, const JavaClass &clazz) {
     auto array = env->NewObjectArray(size, clazz.nativeClass, nullptr);
     checkException();
     return JavaArray<JavaObject>(array);
 }
+
+JavaArray<JavaObject> JavaVirtualMachine::createObjectArray(span<const JavaObject> elements, const JavaClass &clazz) {
+    return createObjectArray(elements, clazz, [](JavaObject elt) {
+        return elt;
+    });
+}
+
+JavaArray<JavaObject> JavaVirtualMachine::createStringArray(span<const string> elements) {
+    return createObjectArray(elements, loadClass("java/lang/String"), [this](const string &elt) {
+        return toJavaString(elt);
+    });
+}
+
+JavaArray<JavaObject> JavaVirtualMachine::createObjectArray(
+        int size, const JavaClass &clazz, const function<JavaObject()> &next) {
+    auto array = env->NewObjectArray(size, clazz.nativeClass, nullptr);
+    checkException();
+
+    for (int start = 0; start < size; start += LOCAL_FRAME_CAPACITY) {
+        int end = min(size, start + LOCAL_FRAME_CAPACITY);
+        if (env->PushLocalFrame(end - start) < 0) {
+            checkException();
+            throw JniException("Could not allocate local references to fill an array");
+        }
+
+        try {
+            for (int i = start; i < end; i++) {
+                env->SetObjectArrayElement(array, i, *next());
+                checkException();
+            }
+        } catch (...) {
+            env->PopLocalFrame(nullptr);
+            throw;
+        }
+        env->PopLocalFrame(nullptr);
+    }
+
+    return JavaArray<JavaObject>(array);
+}
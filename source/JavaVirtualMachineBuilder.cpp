@@ -22,6 +22,8 @@
 #include <iterator>
 #include <sstream>
 
+#include "crillab-easyjni/BulkDispatcherClass.h"
+#include "crillab-easyjni/JavaBulkDispatcher.h"
 #include "crillab-easyjni/JavaVirtualMachineBuilder.h"
 #include "crillab-easyjni/JniException.h"
 
@@ -87,6 +89,7 @@ JavaVirtualMachine *JavaVirtualMachineBuilder::buildJavaVirtualMachine() {
     jint result = JNI_CreateJavaVM(&jvm, (void**) &env, &jvmArgs);
     delete[] vmOptions;
     if (result == JNI_OK) {
+        defineEmbeddedClasses(jvm, env);
         return new JavaVirtualMachine(jvm, env);
     }
 
@@ -94,6 +97,19 @@ JavaVirtualMachine *JavaVirtualMachineBuilder::buildJavaVirtualMachine() {
     throw JniException(result, "Could not create a Java Virtual Machine");
 }
 
+void JavaVirtualMachineBuilder::defineEmbeddedClasses(JavaVM *jvm, JNIEnv *env) {
+    jclass dispatcher = env->DefineClass(
+            JavaBulkDispatcher::CLASS_NAME, nullptr,
+            reinterpret_cast<const jbyte *>(bulkDispatcherBytecode), sizeof(bulkDispatcherBytecode));
+    if (dispatcher == nullptr) {
+        // The JVM cannot be used without its helpers.
+        env->ExceptionClear();
+        jvm->DestroyJavaVM();
+        throw JniException("Could not define class " + string(JavaBulkDispatcher::CLASS_NAME));
+    }
+    env->DeleteLocalRef(dispatcher);
+}
+
 string JavaVirtualMachineBuilder::buildClasspath() {
     stringstream result;
     copy(classpath.begin(), classpath.end(), ostream_iterator<string>(result, CLASSPATH_SEPARATOR));
@@ -18,6 +18,8 @@
  * If not, see {@link http://www.gnu.org/licenses}.
  */
 
+#include <cassert>
+
 #include "crillab-easyjni/JavaVirtualMachineRegistry.h"
 #include "crillab-easyjni/JniException.h"
 
@@ -27,6 +29,25 @@ using namespace std;
 JavaVirtualMachine *JavaVirtualMachineRegistry::mainJvm = nullptr;
 map<thread::id, JavaVirtualMachine *> JavaVirtualMachineRegistry::jvmByThread;
 mutex JavaVirtualMachineRegistry::mutex;
+atomic<unsigned long> JavaVirtualMachineRegistry::generation(0);
+AttachPolicy JavaVirtualMachineRegistry::attachPolicy = AttachPolicy::NORMAL;
+string JavaVirtualMachineRegistry::threadNamePrefix = "easyjni-thread";
+unsigned long JavaVirtualMachineRegistry::nbNamedThreads = 0;
+thread_local JavaVirtualMachineRegistry::ThreadAttachment JavaVirtualMachineRegistry::current;
+
+JavaVirtualMachineRegistry::ThreadAttachment::~ThreadAttachment() {
+    // The thread is only detached if its JVM is still alive, and is not the main one.
+    if ((jvm == nullptr) || (generation != JavaVirtualMachineRegistry::generation.load()) || jvm->main) {
+        return;
+    }
+
+    try {
+        detachCurrentThread();
+
+    } catch (...) {
+        // Nothing can be done while the thread exits.
+    }
+}
 
 void JavaVirtualMachineRegistry::set(JavaVirtualMachine *jvm) {
     mutex.lock();
@@ -40,11 +61,20 @@ void JavaVirtualMachineRegistry::set(JavaVirtualMachine *jvm) {
     // The JVM is saved, and attached to the current thread.
     mainJvm = jvm;
     jvmByThread[this_thread::get_id()] = jvm;
+    cacheCurrentJvm(jvm);
 
     mutex.unlock();
 }
 
 JavaVirtualMachine *JavaVirtualMachineRegistry::get() {
+    // If the current thread has already been attached, its JVM is returned without locking.
+    if ((current.jvm != nullptr) && (current.generation == generation.load(memory_order_acquire))) {
+        return current.jvm;
+    }
+    return attachCurrentThread();
+}
+
+JavaVirtualMachine *JavaVirtualMachineRegistry::attachCurrentThread() {
     mutex.lock();
 
     // If there is no JVM at all, there is nothing to return.
@@ -56,21 +86,43 @@ JavaVirtualMachine *JavaVirtualMachineRegistry::get() {
     // If the current thread is already attached to a JVM, this JVM is returned.
     auto jvm = jvmByThread.find(this_thread::get_id());
     if (jvm != jvmByThread.end()) {
+        cacheCurrentJvm(jvm->second);
         mutex.unlock();
         return jvm->second;
     }
 
     // The current thread has to be attached to a "new" JVM.
     JNIEnv *env;
-    mainJvm->jvm->AttachCurrentThread((void **) &env, nullptr);
+    jint result;
+    if (attachPolicy == AttachPolicy::DAEMON) {
+        result = mainJvm->jvm->AttachCurrentThreadAsDaemon((void **) &env, nullptr);
+
+    } else if (attachPolicy == AttachPolicy::NAMED) {
+        string name = threadNamePrefix + "-" + to_string(++nbNamedThreads);
+        JavaVMAttachArgs args;
+        args.version = JNI_VERSION_1_8;
+        args.name = name.data();
+        args.group = nullptr;
+        result = mainJvm->jvm->AttachCurrentThread((void **) &env, &args);
+
+    } else {
+        result = mainJvm->jvm->AttachCurrentThread((void **) &env, nullptr);
+    }
+
+    if (result != JNI_OK) {
+        mutex.unlock();
+        throw JniException(result, "Could not attach thread to the Java Virtual Machine");
+    }
     auto newJvm = new JavaVirtualMachine(mainJvm->jvm, env, false);
     jvmByThread[this_thread::get_id()] = newJvm;
+    cacheCurrentJvm(newJvm);
 
     mutex.unlock();
     return newJvm;
 }
 
 JNIEnv *JavaVirtualMachineRegistry::getEnvironment() {
+    assert(!JavaContext::isInCriticalRegion() && "No JNI call may be performed while a CriticalView is held");
     auto jvm = get();
     if (jvm == nullptr) {
         return nullptr;
@@ -78,6 +130,21 @@ JNIEnv *JavaVirtualMachineRegistry::getEnvironment() {
     return jvm->env;
 }
 
+void JavaVirtualMachineRegistry::setAttachPolicy(AttachPolicy policy, const string &namePrefix) {
+    mutex.lock();
+    attachPolicy = policy;
+    threadNamePrefix = namePrefix;
+    mutex.unlock();
+}
+
+JavaContext JavaVirtualMachineRegistry::getContext(JavaContext::ExceptionPolicy policy) {
+    auto env = getEnvironment();
+    if (env == nullptr) {
+        throw JniException("No Java Virtual Machine has been registered");
+    }
+    return JavaContext(env, policy);
+}
+
 void JavaVirtualMachineRegistry::detachCurrentThread() {
     mutex.lock();
 
@@ -98,6 +165,7 @@ void JavaVirtualMachineRegistry::detachCurrentThread() {
     mainJvm->jvm->DetachCurrentThread();
     delete jvm->second;
     jvmByThread.erase(this_thread::get_id());
+    current.jvm = nullptr;
 
     mutex.unlock();
 }
@@ -106,11 +174,17 @@ void JavaVirtualMachineRegistry::clear() {
     mutex.lock();
 
     if (mainJvm != nullptr) {
-        // Each JVM must be destroyed.
-        delete mainJvm;
+        // The JVMs cached by the threads are invalidated before being destroyed.
+        generation.fetch_add(1, memory_order_release);
+        current.jvm = nullptr;
+
+        // Each JVM must be destroyed (the main one being also in the map).
         for (auto &jvm : jvmByThread) {
-            delete jvm.second;
+            if (jvm.second != mainJvm) {
+                delete jvm.second;
+            }
         }
+        delete mainJvm;
 
         // We restore all fields to their initial state.
         mainJvm = nullptr;
@@ -119,3 +193,8 @@ void JavaVirtualMachineRegistry::clear() {
 
     mutex.unlock();
 }
+
+void JavaVirtualMachineRegistry::cacheCurrentJvm(JavaVirtualMachine *jvm) {
+    current.jvm = jvm;
+    current.generation = generation.load(memory_order_relaxed);
+}
@@ -0,0 +1,237 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+package fr.univartois.cril.easyjni;
+
+import java.lang.invoke.MethodHandle;
+import java.lang.invoke.MethodHandles;
+import java.lang.invoke.MethodType;
+import java.lang.reflect.AccessibleObject;
+import java.lang.reflect.Constructor;
+import java.lang.reflect.Method;
+import java.lang.reflect.Modifier;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.StandardCharsets;
+import java.util.Arrays;
+
+/**
+ * The BulkDispatcher executes, in a single downcall from the native side, a batch
+ * of method invocations that have been packed into a direct buffer.
+ * This class is embedded into EasyJNI, and defined when the Java Virtual Machine
+ * is created.
+ *
+ * Each call is encoded as follows (in native byte order):
+ * the index of the method to invoke in the array of targets, the index of the
+ * slot holding the receiver (or -1 for static methods and constructors), the index
+ * of the slot in which to store the result (or -1 to discard it), the number of
+ * arguments, and then each argument, as a tag followed by its value.
+ * The tags are those of JNI descriptors for primitive values, 'L' for an object
+ * stored in a slot (or null for index -1), and 'T' for a string encoded in UTF-8
+ * and preceded by its length.
+ *
+ * Targets are invoked through method handles sharing the same generic type, so
+ * that they can be called with invokeExact() rather than by reflection.
+ *
+ * As preparing a target ignores access control, this class and its methods are
+ * not public: they are only meant to be called through JNI, which ignores Java
+ * access modifiers.
+ *
+ * @author Romain Wallon
+ *
+ * @version 0.1.0
+ */
+final class BulkDispatcher {
+
+    /**
+     * The type shared by all prepared targets, which take the receiver of the call
+     * (ignored for static methods and constructors) and its spread arguments.
+     */
+    private static final MethodType TARGET_TYPE =
+            MethodType.methodType(Object.class, Object.class, Object[].class);
+
+    /**
+     * The maximum number of arguments for which an argument array is reused.
+     */
+    private static final int MAX_REUSED_ARITY = 16;
+
+    /**
+     * Disables instantiation.
+     */
+    private BulkDispatcher() {
+        throw new AssertionError("No BulkDispatcher instances for you!");
+    }
+
+    /**
+     * Prepares a method or a constructor to be invoked by this dispatcher.
+     * Like JNI, the dispatcher ignores access control whenever possible.
+     *
+     * @param target The method or constructor to prepare.
+     *
+     * @return The method handle invoking the target, of type {@link #TARGET_TYPE}.
+     *
+     * @throws IllegalAccessException If the target is not accessible.
+     */
+    static MethodHandle prepare(AccessibleObject target) throws IllegalAccessException {
+        try {
+            target.setAccessible(true);
+
+        } catch (RuntimeException e) {
+            // The target remains accessible only if it is public.
+        }
+
+        // Spreading the arguments of the target, and adding a receiver if it has none.
+        MethodHandles.Lookup lookup = MethodHandles.lookup();
+        MethodHandle handle;
+        if (target instanceof Constructor) {
+            Constructor<?> constructor = (Constructor<?>) target;
+            handle = lookup.unreflectConstructor(constructor)
+                    .asSpreader(Object[].class, constructor.getParameterCount());
+            handle = MethodHandles.dropArguments(handle, 0, Object.class);
+
+        } else {
+            Method method = (Method) target;
+            handle = lookup.unreflect(method).asSpreader(Object[].class, method.getParameterCount());
+            if (Modifier.isStatic(method.getModifiers())) {
+                handle = MethodHandles.dropArguments(handle, 0, Object.class);
+            }
+        }
+        return handle.asType(TARGET_TYPE);
+    }
+
+    /**
+     * Executes all the calls packed in the given buffer.
+     *
+     * @param calls The buffer containing the calls to execute.
+     * @param targets The methods and constructors that may be invoked.
+     * @param slots The slots holding the objects shared with the native side.
+     *
+     * @throws Throwable If one of the calls fails.
+     */
+    static void dispatch(ByteBuffer calls, Object[] targets, Object[] slots) throws Throwable {
+        calls.order(ByteOrder.nativeOrder());
+        Object[][] reusedArguments = new Object[MAX_REUSED_ARITY + 1][];
+        for (int index = 0; calls.hasRemaining(); index++) {
+            // Decoding the call.
+            MethodHandle target = (MethodHandle) targets[calls.getInt()];
+            int receiver = calls.getInt();
+            int result = calls.getInt();
+            Object[] arguments = argumentsOf(reusedArguments, calls.getInt());
+            for (int i = 0; i < arguments.length; i++) {
+                arguments[i] = readArgument(calls, slots);
+            }
+
+            // Executing the call (the arguments are copied out of the array when spread).
+            Object value;
+            try {
+                value = (Object) target.invokeExact((receiver < 0) ? null : slots[receiver], arguments);
+
+            } catch (Throwable e) {
+                throw new IllegalStateException("Call #" + index + " of the batch failed", e);
+            }
+
+            if (result >= 0) {
+                slots[result] = value;
+            }
+        }
+    }
+
+    /**
+     * Releases the objects held by the given slots.
+     *
+     * @param slots The slots to clear.
+     * @param size The number of slots that are in use.
+     */
+    static void clear(Object[] slots, int size) {
+        Arrays.fill(slots, 0, size, null);
+    }
+
+    /**
+     * Gives an array in which to store the arguments of a call.
+     * Arrays are reused across the calls having the same number of arguments.
+     *
+     * @param reusedArguments The arrays that are reused, indexed by their length.
+     * @param nbArguments The number of arguments of the call.
+     *
+     * @return The array in which to store the arguments.
+     */
+    private static Object[] argumentsOf(Object[][] reusedArguments, int nbArguments) {
+        if (nbArguments > MAX_REUSED_ARITY) {
+            return new Object[nbArguments];
+        }
+
+        Object[] arguments = reusedArguments[nbArguments];
+        if (arguments == null) {
+            arguments = new Object[nbArguments];
+            reusedArguments[nbArguments] = arguments;
+        }
+        return arguments;
+    }
+
+    /**
+     * Reads the next argument packed in the given buffer.
+     *
+     * @param calls The buffer containing the calls to execute.
+     * @param slots The slots holding the objects shared with the native side.
+     *
+     * @return The read argument.
+     */
+    private static Object readArgument(ByteBuffer calls, Object[] slots) {
+        byte tag = calls.get();
+        switch (tag) {
+            case 'Z':
+                return calls.get() != 0;
+
+            case 'B':
+                return calls.get();
+
+            case 'C':
+                return calls.getChar();
+
+            case 'S':
+                return calls.getShort();
+
+            case 'I':
+                return calls.getInt();
+
+            case 'J':
+                return calls.getLong();
+
+            case 'F':
+                return calls.getFloat();
+
+            case 'D':
+                return calls.getDouble();
+
+            case 'L':
+                int slot = calls.getInt();
+                return (slot < 0) ? null : slots[slot];
+
+            case 'T':
+                byte[] bytes = new byte[calls.getInt()];
+                calls.get(bytes);
+                return new String(bytes, StandardCharsets.UTF_8);
+
+            default:
+                throw new IllegalArgumentException("Unknown argument tag: " + (char) tag);
+        }
+    }
+
+}
@@ -0,0 +1,180 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <jni.h>
+
+#include <crillab-easyjni/JavaArrayAlgorithms.h>
+
+using namespace easyjni;
+using namespace std;
+
+/**
+ * The number of checks that have failed so far.
+ */
+static int nbFailures = 0;
+
+/**
+ * Checks a condition, and reports it if it does not hold.
+ *
+ * @param condition The condition to check.
+ * @param description The description of the condition.
+ */
+static void check(bool condition, const string &description) {
+    if (!condition) {
+        cerr << "FAILED: " << description << endl;
+        nbFailures++;
+    }
+}
+
+/**
+ * Creates a NaN carrying the given payload, so that NaNs can be told apart.
+ *
+ * @param payload The payload of the NaN.
+ *
+ * @return The NaN with the given payload.
+ */
+static jdouble nanWithPayload(uint64_t payload) {
+    return bit_cast<jdouble>(0x7FF8000000000000ULL | payload);
+}
+
+/**
+ * Checks that floating point values are sorted as java.util.Arrays sorts them,
+ * i.e., with -0.0 before 0.0 and NaN after all other values.
+ */
+static void testFloatingPointOrder() {
+    vector<jdouble> values = {
+            numeric_limits<jdouble>::quiet_NaN(), 0.0, 1.0, -0.0, -numeric_limits<jdouble>::infinity(),
+            numeric_limits<jdouble>::infinity(), -1.0, 0.0, -0.0
+    };
+    JavaArrayAlgorithms::sort(span<jdouble>(values), 1);
+
+    check(isinf(values[0]) && signbit(values[0]), "-Infinity comes first");
+    check(bit_cast<uint64_t>(values[1]) == bit_cast<uint64_t>(-1.0), "-1.0 comes after -Infinity");
+    check(!isnan(values[2]) && signbit(values[2]) && !isnan(values[3]) && signbit(values[3]),
+          "-0.0 comes before 0.0");
+    check(bit_cast<uint64_t>(values[4]) == 0 && bit_cast<uint64_t>(values[5]) == 0, "0.0 comes after -0.0");
+    check(isinf(values[7]) && !signbit(values[7]), "Infinity comes before NaN");
+    check(isnan(values[8]), "NaN comes last");
+}
+
+/**
+ * Checks that the parallel stable sort preserves the order of equal values, when
+ * it merges sorted chunks of an array larger than the parallel threshold.
+ * All NaNs are equal to each other in the order of Java, so their payloads tell
+ * whether their relative order has been preserved.
+ */
+static void testParallelStability() {
+    size_t size = 4 * JavaArrayAlgorithms::PARALLEL_THRESHOLD + 17;
+    vector<jdouble> values(size);
+    uint64_t nbNaNs = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (i % 3 == 0) {
+            values[i] = nanWithPayload(++nbNaNs);
+        } else {
+            values[i] = static_cast<jdouble>((i * 7919) % 1000);
+        }
+    }
+    JavaArrayAlgorithms::stableSort(span<jdouble>(values), 4);
+
+    bool sorted = true;
+    for (size_t i = 1; i < size - nbNaNs; i++) {
+        sorted = sorted && !(values[i] < values[i - 1]);
+    }
+    check(sorted, "values before NaNs are sorted");
+
+    bool stable = true;
+    for (size_t i = 0; i < nbNaNs; i++) {
+        auto value = values[size - nbNaNs + i];
+        stable = stable && isnan(value) && ((bit_cast<uint64_t>(value) & 0xFFFFFFFFULL) == i + 1);
+    }
+    check(stable, "NaNs keep their relative order after a parallel stable sort");
+}
+
+/**
+ * Checks that the parallel sort gives the same result as a sequential sort.
+ */
+static void testParallelSort() {
+    size_t size = 3 * JavaArrayAlgorithms::PARALLEL_THRESHOLD + 5;
+    vector<jlong> values(size);
+    for (size_t i = 0; i < size; i++) {
+        values[i] = static_cast<jlong>(i * 0x9E3779B97F4A7C15ULL);
+    }
+    auto sequential = values;
+    JavaArrayAlgorithms::sort(span<jlong>(values), 4);
+    JavaArrayAlgorithms::sort(span<jlong>(sequential), 1);
+    check(values == sequential, "parallel and sequential sorts agree");
+}
+
+/**
+ * Checks that nthElement puts the expected value at its sorted position.
+ */
+static void testNthElement() {
+    vector<jint> values(1000);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = static_cast<jint>((i * 7919) % values.size());
+    }
+    JavaArrayAlgorithms::nthElement(span<jint>(values), 500);
+    check(values[500] == 500, "nthElement puts the median at its sorted position");
+}
+
+/**
+ * Checks that binarySearch encodes misses as java.util.Arrays does, that is,
+ * as (-(insertion point) - 1).
+ */
+static void testBinarySearch() {
+    vector<jint> values = {1, 3, 5, 7};
+    span<const jint> view(values);
+    check(JavaArrayAlgorithms::binarySearch(view, 5) == 2, "hit gives the index of the key");
+    check(JavaArrayAlgorithms::binarySearch(view, 0) == -1, "miss before the first value");
+    check(JavaArrayAlgorithms::binarySearch(view, 4) == -3, "miss between two values");
+    check(JavaArrayAlgorithms::binarySearch(view, 8) == -5, "miss after the last value");
+    check(JavaArrayAlgorithms::binarySearch(span<const jint>(), 8) == -1, "miss in an empty array");
+
+    vector<jdouble> doubles = {-0.0, 0.0, numeric_limits<jdouble>::quiet_NaN()};
+    span<const jdouble> doubleView(doubles);
+    check(JavaArrayAlgorithms::binarySearch(doubleView, 0.0) == 1, "0.0 is found after -0.0");
+    check(JavaArrayAlgorithms::binarySearch(doubleView, -0.0) == 0, "-0.0 is found before 0.0");
+    check(JavaArrayAlgorithms::binarySearch(doubleView, numeric_limits<jdouble>::quiet_NaN()) == 2,
+          "NaN is found after all other values");
+}
+
+/**
+ * Runs the tests of the algorithms.
+ *
+ * @return The value 0 if all the tests pass, and 1 otherwise.
+ */
+int main() {
+    testFloatingPointOrder();
+    testParallelStability();
+    testParallelSort();
+    testNthElement();
+    testBinarySearch();
+    cout << "Algorithms: " << nbFailures << " failure(s)" << endl;
+    return (nbFailures == 0) ? 0 : 1;
+}
@@ -0,0 +1,178 @@
+/**
+ * EasyJNI - Invoking Java code from C++ made easy.
+ * Copyright (c) 2022 - Univ Artois & CNRS & Exakis Nelite.
+ * All rights reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library.
+ * If not, see {@link http://www.gnu.org/licenses}.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <jni.h>
+
+#include <crillab-easyjni/JavaArrayKernels.h>
+#include <crillab-easyjni/JniException.h>
+
+using namespace easyjni;
+using namespace std;
+
+/**
+ * The number of checks that have failed so far.
+ */
+static int nbFailures = 0;
+
+/**
+ * Checks a condition, and reports it if it does not hold.
+ *
+ * @param condition The condition to check.
+ * @param description The description of the condition.
+ */
+static void check(bool condition, const string &description) {
+    if (!condition) {
+        cerr << "FAILED: " << description << endl;
+        nbFailures++;
+    }
+}
+
+/**
+ * Gives the bytes of a string, as Java would store them in a byte array.
+ *
+ * @param str The string to get the bytes of.
+ *
+ * @return The bytes of the string.
+ */
+static vector<jbyte> bytesOf(const string &str) {
+    return vector<jbyte>(str.begin(), str.end());
+}
+
+/**
+ * Checks the CRC-32 checksums computed by the kernels against known vectors,
+ * including inputs long enough to be handled by the vectorized code.
+ */
+static void testCrc32() {
+    check(JavaArrayKernels::crc32(bytesOf("")) == 0, "CRC-32 of empty input");
+    check(JavaArrayKernels::crc32(bytesOf("123456789")) == 0xCBF43926U, "CRC-32 of 123456789");
+    check(JavaArrayKernels::crc32(bytesOf("The quick brown fox jumps over the lazy dog")) == 0x414FA339U,
+          "CRC-32 of the quick brown fox");
+
+    vector<jbyte> bytes(100003);
+    for (size_t i = 0; i < bytes.size(); i++) {
+        bytes[i] = static_cast<jbyte>(i * 31 + 7);
+    }
+    span<const jbyte> all(bytes);
+    auto crc = JavaArrayKernels::crc32(all);
+    auto chained = JavaArrayKernels::crc32(all.subspan(4099), JavaArrayKernels::crc32(all.first(4099)));
+    check(crc == chained, "CRC-32 chained over two parts of a long input");
+}
+
+/**
+ * Checks the 64-bit xxHash computed by the kernels against known vectors,
+ * including an input longer than a stripe of 32 bytes.
+ */
+static void testXxHash64() {
+    check(JavaArrayKernels::xxHash64(bytesOf("")) == 0xEF46DB3751D8E999ULL, "xxHash64 of empty input");
+    check(JavaArrayKernels::xxHash64(bytesOf("a")) == 0xD24EC4F1A98C6E5BULL, "xxHash64 of a");
+    check(JavaArrayKernels::xxHash64(bytesOf("abc")) == 0x44BC2CF5AD770999ULL, "xxHash64 of abc");
+    check(JavaArrayKernels::xxHash64(bytesOf("Nobody inspects the spammish repetition")) == 0xFBCEA83C8A378BF1ULL,
+          "xxHash64 of a multi-stripe input");
+}
+
+/**
+ * Checks that the sums and dot products of integers wrap around on overflow,
+ * as they do in Java.
+ */
+static void testWrapAround() {
+    vector<jlong> longs(1001, numeric_limits<jlong>::max());
+    uint64_t expected = 0;
+    for (auto value : longs) {
+        expected += static_cast<uint64_t>(value);
+    }
+    check(JavaArrayKernels::sum(span<const jlong>(longs)) == static_cast<jlong>(expected),
+          "sum of longs wraps around");
+
+    vector<jint> ints(1001, numeric_limits<jint>::min());
+    expected = 0;
+    for (auto value : ints) {
+        expected += static_cast<uint64_t>(static_cast<jlong>(value) * value);
+    }
+    check(JavaArrayKernels::dot(span<const jint>(ints), span<const jint>(ints)) == static_cast<jlong>(expected),
+          "dot product of ints wraps around");
+
+    vector<jint> scaled(1001, numeric_limits<jint>::max());
+    JavaArrayKernels::scale(span<jint>(scaled), 2);
+    check(scaled.front() == -2 && scaled.back() == -2, "scaling ints wraps around");
+}
+
+/**
+ * Checks that the minimum and maximum of floating point values are both NaN
+ * when any of the values is NaN, wherever this value is.
+ */
+static void testMinMaxNaN() {
+    vector<jdouble> doubles(1001);
+    for (size_t i = 0; i < doubles.size(); i++) {
+        doubles[i] = static_cast<jdouble>(i);
+    }
+    auto [min, max] = JavaArrayKernels::minMax(span<const jdouble>(doubles));
+    check(!isnan(min) && !isnan(max) && (min < 1) && (max > 999), "min and max of doubles without NaN");
+
+    for (size_t position : {size_t(0), size_t(17), doubles.size() - 1}) {
+        auto copy = doubles;
+        copy[position] = numeric_limits<jdouble>::quiet_NaN();
+        auto [nanMin, nanMax] = JavaArrayKernels::minMax(span<const jdouble>(copy));
+        check(isnan(nanMin) && isnan(nanMax), "min and max of doubles with NaN at " + to_string(position));
+    }
+
+    vector<jfloat> floats(1001, 1.0F);
+    floats[500] = numeric_limits<jfloat>::quiet_NaN();
+    auto [floatMin, floatMax] = JavaArrayKernels::minMax(span<const jfloat>(floats));
+    check(isnan(floatMin) && isnan(floatMax), "min and max of floats with NaN");
+}
+
+/**
+ * Checks that the dot product rejects vectors of different lengths.
+ */
+static void testDotLengthMismatch() {
+    vector<jint> x(10);
+    vector<jint> y(11);
+    try {
+        JavaArrayKernels::dot(span<const jint>(x), span<const jint>(y));
+        check(false, "dot product of vectors of different lengths throws");
+
+    } catch (JniException &) {
+        // This is the expected behavior.
+    }
+}
+
+/**
+ * Runs the tests of the kernels.
+ *
+ * @return The value 0 if all the tests pass, and 1 otherwise.
+ */
+int main() {
+    testCrc32();
+    testXxHash64();
+    testWrapAround();
+    testMinMaxNaN();
+    testDotLengthMismatch();
+    cout << "Kernels dispatched to " << JavaArrayKernels::getInstructionSet() << ": "
+         << nbFailures << " failure(s)" << endl;
+    return (nbFailures == 0) ? 0 : 1;
+}